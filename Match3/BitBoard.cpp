@@ -0,0 +1,244 @@
+#include "GameImpl.h"
+#include "CpuFeatures.h"
+
+#ifdef MATCH3_X86
+#include <immintrin.h>
+#endif
+
+template<int Rows, int Columns, int Types>
+constexpr typename BasicBitBoard<Rows, Columns, Types>::Mask BasicBitBoard<Rows, Columns, Types>::BOARD_MASK;
+
+template<int Rows, int Columns, int Types>
+constexpr typename BasicBitBoard<Rows, Columns, Types>::Mask BasicBitBoard<Rows, Columns, Types>::HORIZONTAL_RUN_STARTS;
+
+template<int Rows, int Columns, int Types>
+BasicBitBoard<Rows, Columns, Types>::BasicBitBoard()
+{
+	clear();
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBitBoard<Rows, Columns, Types>::clear()
+{
+	for(int i = 0; i < LANES; ++i)
+	{
+		typeMasks[i] = Ops::zero();
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBitBoard<Rows, Columns, Types>::setType(int x, int y, int type)
+{
+	Mask cell = cellMask(x, y);
+	for(int i = 0; i < Types; ++i)
+	{
+		typeMasks[i] &= ~cell;
+	}
+	if(type != -1)
+	{
+		typeMasks[type - TID_BLOCK_1] |= cell;
+	}
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBitBoard<Rows, Columns, Types>::getType(int x, int y) const
+{
+	Mask cell = cellMask(x, y);
+	for(int i = 0; i < Types; ++i)
+	{
+		if(!Ops::isZero(typeMasks[i] & cell))
+		{
+			return TID_BLOCK_1 + i;
+		}
+	}
+	return -1;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBitBoard<Rows, Columns, Types>::swapTypes(int srcX, int srcY, int dstX, int dstY)
+{
+	Mask src = cellMask(srcX, srcY);
+	Mask dst = cellMask(dstX, dstY);
+	for(int i = 0; i < Types; ++i)
+	{
+		//exchange the two bits only if they differ
+		Mask m = typeMasks[i];
+		if(Ops::isZero(m & src) != Ops::isZero(m & dst))
+		{
+			typeMasks[i] = m ^ (src | dst);
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+typename BasicBitBoard<Rows, Columns, Types>::Mask BasicBitBoard<Rows, Columns, Types>::occupied() const
+{
+	Mask mask = Ops::zero();
+	for(int i = 0; i < Types; ++i)
+	{
+		mask |= typeMasks[i];
+	}
+	return mask;
+}
+
+template<int Rows, int Columns, int Types>
+typename BasicBitBoard<Rows, Columns, Types>::Mask BasicBitBoard<Rows, Columns, Types>::findKillsScalar() const
+{
+	const Mask starts = HORIZONTAL_RUN_STARTS;
+	Mask kills = Ops::zero();
+	for(int i = 0; i < Types; ++i)
+	{
+		const Mask &m = typeMasks[i];
+		//run start bits, then spread them over the whole run
+		Mask h = m & (m >> 1) & (m >> 2) & starts;
+		Mask v = m & (m >> Columns) & (m >> (2 * Columns));
+		kills |= h | (h << 1) | (h << 2);
+		kills |= v | (v << Columns) | (v << (2 * Columns));
+	}
+	return kills;
+}
+
+//SIMD kernels work on 64 bit lanes, so they are used only for single word boards
+template<typename BitBoardT, bool SingleWord = BitBoardT::SINGLE_WORD>
+struct SIMDKills
+{
+	static typename BitBoardT::Mask findKillsSSE2(const BitBoardT &board)
+	{
+		return board.findKillsScalar();
+	}
+
+	static typename BitBoardT::Mask findKillsAVX2(const BitBoardT &board)
+	{
+		return board.findKillsScalar();
+	}
+};
+
+#ifdef MATCH3_X86
+
+MATCH3_TARGET_SSE2 static uint64_t reduceKills(__m128i kills)
+{
+	kills = _mm_or_si128(kills, _mm_unpackhi_epi64(kills, kills));
+	uint64_t result;
+	_mm_storel_epi64((__m128i*)&result, kills);
+	return result;
+}
+
+template<int Rows, int Columns, int Types>
+MATCH3_TARGET_SSE2 static uint64_t findKillsSSE2Kernel(const BasicBitBoard<Rows, Columns, Types> &board)
+{
+	const __m128i starts = _mm_set1_epi64x((long long)board.HORIZONTAL_RUN_STARTS);
+	__m128i kills = _mm_setzero_si128();
+	for(int i = 0; i < board.LANES; i += 2)
+	{
+		__m128i m = _mm_loadu_si128((const __m128i*)&board.typeMasks[i]);
+		__m128i h = _mm_and_si128(_mm_and_si128(m, starts),
+			_mm_and_si128(_mm_srli_epi64(m, 1), _mm_srli_epi64(m, 2)));
+		__m128i v = _mm_and_si128(m,
+			_mm_and_si128(_mm_srli_epi64(m, Columns), _mm_srli_epi64(m, 2 * Columns)));
+		kills = _mm_or_si128(kills, _mm_or_si128(h, _mm_or_si128(_mm_slli_epi64(h, 1), _mm_slli_epi64(h, 2))));
+		kills = _mm_or_si128(kills, _mm_or_si128(v,
+			_mm_or_si128(_mm_slli_epi64(v, Columns), _mm_slli_epi64(v, 2 * Columns))));
+	}
+	return reduceKills(kills);
+}
+
+template<int Rows, int Columns, int Types>
+MATCH3_TARGET_AVX2 static uint64_t findKillsAVX2Kernel(const BasicBitBoard<Rows, Columns, Types> &board)
+{
+	const __m256i starts = _mm256_set1_epi64x((long long)board.HORIZONTAL_RUN_STARTS);
+	__m256i kills = _mm256_setzero_si256();
+	for(int i = 0; i < board.LANES; i += 4)
+	{
+		__m256i m = _mm256_loadu_si256((const __m256i*)&board.typeMasks[i]);
+		__m256i h = _mm256_and_si256(_mm256_and_si256(m, starts),
+			_mm256_and_si256(_mm256_srli_epi64(m, 1), _mm256_srli_epi64(m, 2)));
+		__m256i v = _mm256_and_si256(m,
+			_mm256_and_si256(_mm256_srli_epi64(m, Columns), _mm256_srli_epi64(m, 2 * Columns)));
+		kills = _mm256_or_si256(kills, _mm256_or_si256(h, _mm256_or_si256(_mm256_slli_epi64(h, 1), _mm256_slli_epi64(h, 2))));
+		kills = _mm256_or_si256(kills, _mm256_or_si256(v,
+			_mm256_or_si256(_mm256_slli_epi64(v, Columns), _mm256_slli_epi64(v, 2 * Columns))));
+	}
+	return reduceKills(_mm_or_si128(_mm256_castsi256_si128(kills), _mm256_extracti128_si256(kills, 1)));
+}
+
+template<typename BitBoardT>
+struct SIMDKills<BitBoardT, true>
+{
+	static uint64_t findKillsSSE2(const BitBoardT &board)
+	{
+		return findKillsSSE2Kernel(board);
+	}
+
+	static uint64_t findKillsAVX2(const BitBoardT &board)
+	{
+		return findKillsAVX2Kernel(board);
+	}
+};
+
+#endif
+
+template<int Rows, int Columns, int Types>
+typename BasicBitBoard<Rows, Columns, Types>::Mask BasicBitBoard<Rows, Columns, Types>::findKillsSSE2() const
+{
+	return SIMDKills<BasicBitBoard>::findKillsSSE2(*this);
+}
+
+template<int Rows, int Columns, int Types>
+typename BasicBitBoard<Rows, Columns, Types>::Mask BasicBitBoard<Rows, Columns, Types>::findKillsAVX2() const
+{
+	return SIMDKills<BasicBitBoard>::findKillsAVX2(*this);
+}
+
+template<int Rows, int Columns, int Types>
+typename BasicBitBoard<Rows, Columns, Types>::Mask BasicBitBoard<Rows, Columns, Types>::findKills() const
+{
+	//kernel is picked once per instantiation
+	static const int kernel = cpuHasAVX2() ? 2 : (cpuHasSSE2() ? 1 : 0);
+	if(2 == kernel)
+	{
+		return findKillsAVX2();
+	}
+	if(1 == kernel)
+	{
+		return findKillsSSE2();
+	}
+	return findKillsScalar();
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBitBoard<Rows, Columns, Types>::findMoves(Mask &rightMoves, Mask &downMoves) const
+{
+	constexpr Mask all = BOARD_MASK;
+	constexpr Mask notLastColumn = columnRange(0, Columns - 2);
+	constexpr Mask pairRightCells = columnRange(0, Columns - 3);
+	constexpr Mask pairLeftCells = columnRange(2, Columns - 1);
+	constexpr Mask pairAroundCells = columnRange(1, Columns - 2);
+
+	Mask right = Ops::zero();
+	Mask down = Ops::zero();
+	for(int i = 0; i < Types; ++i)
+	{
+		const Mask &m = typeMasks[i];
+		//cells where a block of this type would complete a run together with
+		//two blocks already on the board: two to the right/left, one on each
+		//side, two below/above, one above and one below
+		Mask toRight = (m >> 1) & (m >> 2) & pairRightCells;
+		Mask toLeft = (m << 1) & (m << 2) & pairLeftCells;
+		Mask aroundH = (m << 1) & (m >> 1) & pairAroundCells;
+		Mask below = (m >> Columns) & (m >> (2 * Columns));
+		Mask above = (m << Columns) & (m << (2 * Columns)) & all;
+		Mask aroundV = (m << Columns) & (m >> Columns) & all;
+		Mask horizontal = toRight | toLeft | aroundH;
+		Mask vertical = below | above | aroundV;
+		//block arriving at a cell can't use the cell it came from, so only
+		//patterns on the far side of the swap count
+		right |= (m & ((toRight | vertical) >> 1)) | ((m >> 1) & (toLeft | vertical));
+		down |= (m & ((below | horizontal) >> Columns)) | ((m >> Columns) & (above | horizontal));
+	}
+	//both blocks have to be movable
+	const Mask movable = occupied();
+	rightMoves = right & notLastColumn & movable & (movable >> 1);
+	downMoves = down & movable & (movable >> Columns);
+}
+
+INSTANTIATE_BOARD_GEOMETRIES(struct BasicBitBoard)
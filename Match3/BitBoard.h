@@ -0,0 +1,314 @@
+#ifndef _BIT_BOARD_H_
+#define _BIT_BOARD_H_
+
+#include <cstdint>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+inline int popCount64(uint64_t m)
+{
+	m = m - ((m >> 1) & 0x5555555555555555ull);
+	m = (m & 0x3333333333333333ull) + ((m >> 2) & 0x3333333333333333ull);
+	m = (m + (m >> 4)) & 0x0f0f0f0f0f0f0f0full;
+	return (int)((m * 0x0101010101010101ull) >> 56);
+}
+
+//index of lowest set bit, m must not be zero
+inline int lowestBit64(uint64_t m)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, m);
+	return (int)index;
+#elif defined(__GNUC__)
+	return __builtin_ctzll(m);
+#else
+	int index = 0;
+	while(!(m & 1))
+	{
+		m >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+//multi word mask for boards with more than 64 cells, supports
+//only operations needed by board searches and shifts below 64 bits
+template<int Words>
+struct WideMask
+{
+	uint64_t				w[Words];
+
+	constexpr WideMask() :
+	w()
+	{
+	}
+
+	friend WideMask operator&(const WideMask &a, const WideMask &b)
+	{
+		WideMask r;
+		for(int i = 0; i < Words; ++i)
+		{
+			r.w[i] = a.w[i] & b.w[i];
+		}
+		return r;
+	}
+
+	friend constexpr WideMask operator|(const WideMask &a, const WideMask &b)
+	{
+		WideMask r;
+		for(int i = 0; i < Words; ++i)
+		{
+			r.w[i] = a.w[i] | b.w[i];
+		}
+		return r;
+	}
+
+	friend WideMask operator^(const WideMask &a, const WideMask &b)
+	{
+		WideMask r;
+		for(int i = 0; i < Words; ++i)
+		{
+			r.w[i] = a.w[i] ^ b.w[i];
+		}
+		return r;
+	}
+
+	friend WideMask operator~(const WideMask &a)
+	{
+		WideMask r;
+		for(int i = 0; i < Words; ++i)
+		{
+			r.w[i] = ~a.w[i];
+		}
+		return r;
+	}
+
+	//towards higher cell indices
+	friend WideMask operator<<(const WideMask &a, int s)
+	{
+		WideMask r;
+		for(int i = Words - 1; i > 0; --i)
+		{
+			r.w[i] = (a.w[i] << s) | (s ? (a.w[i - 1] >> (64 - s)) : 0);
+		}
+		r.w[0] = a.w[0] << s;
+		return r;
+	}
+
+	//towards lower cell indices
+	friend WideMask operator>>(const WideMask &a, int s)
+	{
+		WideMask r;
+		for(int i = 0; i < Words - 1; ++i)
+		{
+			r.w[i] = (a.w[i] >> s) | (s ? (a.w[i + 1] << (64 - s)) : 0);
+		}
+		r.w[Words - 1] = a.w[Words - 1] >> s;
+		return r;
+	}
+
+	WideMask &operator&=(const WideMask &a)
+	{
+		return *this = *this & a;
+	}
+
+	constexpr WideMask &operator|=(const WideMask &a)
+	{
+		return *this = *this | a;
+	}
+
+	WideMask &operator^=(const WideMask &a)
+	{
+		return *this = *this ^ a;
+	}
+
+	friend bool operator==(const WideMask &a, const WideMask &b)
+	{
+		for(int i = 0; i < Words; ++i)
+		{
+			if(a.w[i] != b.w[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	friend bool operator!=(const WideMask &a, const WideMask &b)
+	{
+		return !(a == b);
+	}
+};
+
+//helpers working on both single and multi word masks
+template<typename Mask>
+struct MaskOps;
+
+template<>
+struct MaskOps<uint64_t>
+{
+	static constexpr uint64_t zero()
+	{
+		return 0;
+	}
+
+	static constexpr uint64_t bit(int index)
+	{
+		return uint64_t(1) << index;
+	}
+
+	static bool isZero(uint64_t m)
+	{
+		return m == 0;
+	}
+
+	static int popCount(uint64_t m)
+	{
+		return popCount64(m);
+	}
+
+	static int lowestBit(uint64_t m)
+	{
+		return lowestBit64(m);
+	}
+};
+
+template<int Words>
+struct MaskOps<WideMask<Words>>
+{
+	static constexpr WideMask<Words> zero()
+	{
+		return WideMask<Words>();
+	}
+
+	static constexpr WideMask<Words> bit(int index)
+	{
+		WideMask<Words> r = zero();
+		r.w[index >> 6] = uint64_t(1) << (index & 63);
+		return r;
+	}
+
+	static bool isZero(const WideMask<Words> &m)
+	{
+		for(int i = 0; i < Words; ++i)
+		{
+			if(m.w[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static int popCount(const WideMask<Words> &m)
+	{
+		int count = 0;
+		for(int i = 0; i < Words; ++i)
+		{
+			count += popCount64(m.w[i]);
+		}
+		return count;
+	}
+
+	static int lowestBit(const WideMask<Words> &m)
+	{
+		for(int i = 0; i < Words; ++i)
+		{
+			if(m.w[i])
+			{
+				return i * 64 + lowestBit64(m.w[i]);
+			}
+		}
+		return -1;
+	}
+};
+
+//one bit per board cell, cell (x, y) is bit y * Columns + x
+template<int Cells>
+struct BlockMaskType
+{
+	typedef typename std::conditional<(Cells <= 64), uint64_t, WideMask<(Cells + 63) / 64>>::type type;
+};
+
+//all cells in columns first...last of a Rows x Columns board, usable in
+//constant expressions so board shape masks cost nothing at run time
+template<typename Mask, int Rows, int Columns>
+constexpr Mask columnRangeMask(int first, int last)
+{
+	Mask mask = MaskOps<Mask>::zero();
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = first; j <= last; ++j)
+		{
+			mask |= MaskOps<Mask>::bit(i * Columns + j);
+		}
+	}
+	return mask;
+}
+
+//board representation with one mask per block type, empty/inactive
+//blocks are simply absent from all masks
+template<int Rows, int Columns, int Types>
+struct BasicBitBoard
+{
+	typedef typename BlockMaskType<Rows * Columns>::type	Mask;
+	typedef MaskOps<Mask>									Ops;
+
+	static const bool SINGLE_WORD = (Rows * Columns <= 64);
+	//type masks of single word boards are padded so that SIMD
+	//kernels can always load full registers; loads are unaligned
+	//since boards embedding this may be heap allocated without
+	//honoring the alignment
+	static const int LANES = SINGLE_WORD ? ((Types + 3) & ~3) : Types;
+
+	alignas(32) Mask		typeMasks[LANES];
+
+	BasicBitBoard();
+
+	void clear();
+	//type is block texture (TID_BLOCK_1...) or -1 for empty/inactive block
+	void setType(int x, int y, int type);
+	int getType(int x, int y) const;
+	void swapTypes(int srcX, int srcY, int dstX, int dstY);
+	Mask occupied() const;
+
+	//all cells of the board
+	static constexpr Mask BOARD_MASK = columnRangeMask<Mask, Rows, Columns>(0, Columns - 1);
+	//cells where a horizontal run of three may start, everything
+	//further right would wrap around to next row
+	static constexpr Mask HORIZONTAL_RUN_STARTS = columnRangeMask<Mask, Rows, Columns>(0, Columns - 3);
+
+	static constexpr Mask cellMask(int x, int y)
+	{
+		return Ops::bit(y * Columns + x);
+	}
+	//all cells in columns first...last
+	static constexpr Mask columnRange(int first, int last)
+	{
+		return columnRangeMask<Mask, Rows, Columns>(first, last);
+	}
+
+	//kill search kernels, all of them return the mask of blocks
+	//belonging to horizontal or vertical runs of three or more,
+	//SIMD kernels are available only for boards up to 64 cells
+	Mask findKillsScalar() const;
+	Mask findKillsSSE2() const;
+	Mask findKillsAVX2() const;
+	//best kernel supported by the running CPU
+	Mask findKills() const;
+
+	//all killing swaps in one pass, bit of cell (x, y) is set in rightMoves
+	//if swapping it with (x + 1, y) kills, in downMoves for (x, y + 1);
+	//exact for boards without pending kills
+	void findMoves(Mask &rightMoves, Mask &downMoves) const;
+};
+
+typedef BasicBitBoard<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> BitBoard;
+typedef BitBoard::Mask BlockMask;
+
+#endif
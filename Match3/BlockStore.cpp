@@ -0,0 +1,474 @@
+#include "Game.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+const int BLOCK_MARK_TIME = 150;
+const int BLOCK_MOVE_TIME = 300;
+const int BLOCK_KILL_TIME = 300;
+const double FALL_ACCELERATION = 25.0;		//board units per second squared
+
+const double MAX_MARKER_OPACITY = 0.5;
+
+template<int Rows, int Columns, int Types>
+BasicBlockStore<Rows, Columns, Types>::BasicBlockStore(Renderer &r) :
+renderer(r)
+{
+	clear();
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::clear()
+{
+	//hand out low slots first
+	numFreeSlots = CAPACITY;
+	for(int i = 0; i < CAPACITY; ++i)
+	{
+		freeSlots[i] = CAPACITY - i - 1;
+		used[i] = false;
+	}
+}
+
+template<int Rows, int Columns, int Types>
+BlockID BasicBlockStore<Rows, Columns, Types>::create(const int bX, const int bY, const TextureID tex)
+{
+	if(0 == numFreeSlots)
+	{
+		throw new NotImplementedException();
+	}
+	BlockID id = freeSlots[--numFreeSlots];
+	used[id] = true;
+	boardX[id] = (int8_t)bX;
+	boardY[id] = (int8_t)bY;
+	texture[id] = (uint8_t)tex;
+	state[id] = BlockState::Normal;
+	markerState[id] = BlockMarkerState::None;
+	selected[id] = false;
+	markerOpacity[id] = 0.0f;
+	markerChangeStartTime[id] = 0;
+	moveOnTop[id] = false;
+	animationStartTime[id] = 0;
+	animationFromScreenX[id] = 0;
+	animationFromScreenY[id] = 0;
+	return id;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::destroy(BlockID id)
+{
+	used[id] = false;
+	freeSlots[numFreeSlots++] = id;
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBlockStore<Rows, Columns, Types>::getScreenXPos(BlockID id) const
+{
+	return BOARD_POS_X + boardX[id] * BLOCK_SIZE_X;
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBlockStore<Rows, Columns, Types>::getScreenYPos(BlockID id) const
+{
+	return BOARD_POS_Y + boardY[id] * BLOCK_SIZE_Y;
+}
+
+template<int Rows, int Columns, int Types>
+unsigned int BasicBlockStore<Rows, Columns, Types>::getAnimationTime(BlockID id, const unsigned int currentTime) const
+{
+	return currentTime > animationStartTime[id] ? currentTime - animationStartTime[id] : 0;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBlockStore<Rows, Columns, Types>::isInside(BlockID id, const int x, const int y) const
+{
+	if(BlockState::Normal != state[id])
+	{
+		throw new NotImplementedException();
+	}
+	int posX = getScreenXPos(id);
+	if(x < posX)
+	{
+		return false;
+	}
+	if(x >= posX + BLOCK_SIZE_X)
+	{
+		return false;
+	}
+	int posY = getScreenYPos(id);
+	if(y < posY)
+	{
+		return false;
+	}
+	if(y >= posY + BLOCK_SIZE_Y)
+	{
+		return false;
+	}
+	return true;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBlockStore<Rows, Columns, Types>::isSelected(BlockID id) const
+{
+	return selected[id];
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBlockStore<Rows, Columns, Types>::isDead(BlockID id) const
+{
+	return state[id] == BlockState::Dead;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBlockStore<Rows, Columns, Types>::canMove(BlockID id) const
+{
+	return BlockState::Normal == state[id];
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBlockStore<Rows, Columns, Types>::isNeighbor(BlockID id, BlockID block) const
+{
+	int diffX = abs(boardX[id] - boardX[block]);
+	int diffY = abs(boardY[id] - boardY[block]);
+	return ((0 == diffX && 1 == diffY) || (1 == diffX && 0 == diffY));
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBlockStore<Rows, Columns, Types>::getBoardX(BlockID id) const
+{
+	return boardX[id];
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBlockStore<Rows, Columns, Types>::getBoardY(BlockID id) const
+{
+	return boardY[id];
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBlockStore<Rows, Columns, Types>::getType(BlockID id) const
+{
+	if(state[id] != BlockState::Normal)
+	{
+		return -1;
+	}
+	return texture[id];
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::getSwapDirection(BlockID id, const int x, const int y, int &dx, int &dy) const
+{
+	int posX = (int)(BOARD_POS_X + (boardX[id] + 0.5) * BLOCK_SIZE_X);
+	int posY = (int)(BOARD_POS_Y + (boardY[id] + 0.5) * BLOCK_SIZE_Y);
+	int pdx = x - posX;
+	int pdy = y - posY;
+	if(abs(pdx) > abs(pdy))
+	{
+		dy = 0;
+		if(pdx > 0)
+		{
+			dx = 1;
+		}
+		else
+		{
+			dx = -1;
+		}
+	}
+	else
+	{
+		dx = 0;
+		if(pdy > 0)
+		{
+			dy = 1;
+		}
+		else
+		{
+			dy = -1;
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::mark(BlockID id, const unsigned int currentTime)
+{
+	if(BlockMarkerState::Marking == markerState[id]  ||
+		BlockMarkerState::Marked == markerState[id])
+	{
+		return;
+	}
+	if(BlockMarkerState::None == markerState[id])
+	{
+		markerChangeStartTime[id] = currentTime;
+	}
+	if(BlockMarkerState::Unmarking == markerState[id])
+	{
+		markerChangeStartTime[id] = currentTime - (unsigned int)(markerOpacity[id] * BLOCK_MARK_TIME);
+	}
+	markerState[id] = BlockMarkerState::Marking;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::unmark(BlockID id, const unsigned int currentTime)
+{
+	if(BlockMarkerState::None == markerState[id]  ||
+		BlockMarkerState::Unmarking == markerState[id])
+	{
+		return;
+	}
+	if(selected[id])
+	{
+		return;
+	}
+	if(BlockMarkerState::Marked == markerState[id])
+	{
+		markerChangeStartTime[id] = currentTime;
+	}
+	if(BlockMarkerState::Marking == markerState[id])
+	{
+		markerChangeStartTime[id] = currentTime - (unsigned int)((1.0 - markerOpacity[id]) * BLOCK_MARK_TIME);
+	}
+	markerState[id] = BlockMarkerState::Unmarking;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::select(BlockID id, const unsigned int currentTime)
+{
+	selected[id] = true;
+	mark(id, currentTime);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::unselect(BlockID id, const unsigned int currentTime)
+{
+	selected[id] = false;
+	unmark(id, currentTime);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::moveTo(BlockID id, const unsigned int currentTime, const int newBoardX,
+						const int newBoardY, const bool topLayer)
+{
+	unselect(id, currentTime);
+	if(BlockState::Normal != state[id])
+	{
+		return;
+	}
+	animationStartTime[id] = currentTime;
+	state[id] = BlockState::Moving;
+	moveOnTop[id] = topLayer;
+	animationFromScreenX[id] = (int16_t)getScreenXPos(id);
+	animationFromScreenY[id] = (int16_t)getScreenYPos(id);
+	boardX[id] = (int8_t)newBoardX;
+	boardY[id] = (int8_t)newBoardY;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::swap(BlockID id, BlockID block, const unsigned int currentTime)
+{
+	int oldBoardX = boardX[id];
+	int oldBoardY = boardY[id];
+	moveTo(id, currentTime, boardX[block], boardY[block], true);
+	moveTo(block, currentTime, oldBoardX, oldBoardY, false);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::kill(BlockID id, const unsigned int currentTime)
+{
+	unselect(id, currentTime);
+	if(BlockState::Normal != state[id])
+	{
+		return;
+	}
+	animationStartTime[id] = currentTime;
+	state[id] = BlockState::Disappearing;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::fallTo(BlockID id, const unsigned int currentTime, const int targetX, const int targetY)
+{
+	unselect(id, currentTime);
+	if(BlockState::Normal != state[id])
+	{
+		return;
+	}
+	animationStartTime[id] = currentTime;
+	state[id] = BlockState::Falling;
+	animationFromScreenX[id] = (int16_t)getScreenXPos(id);
+	animationFromScreenY[id] = (int16_t)getScreenYPos(id);
+	boardX[id] = (int8_t)targetX;
+	boardY[id] = (int8_t)targetY;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBlockStore<Rows, Columns, Types>::simulate(BlockID id, const unsigned int currentTime)
+{
+	if(BlockMarkerState::Marking == markerState[id])
+	{
+		if(currentTime > markerChangeStartTime[id] + BLOCK_MARK_TIME)
+		{
+			markerState[id] = BlockMarkerState::Marked;
+			markerOpacity[id] = 1.0f;
+		}
+		else
+		{
+			markerOpacity[id] = (float)((currentTime - markerChangeStartTime[id])/(double)BLOCK_MARK_TIME);
+		}
+	}
+	if(BlockMarkerState::Unmarking == markerState[id])
+	{
+		if(currentTime > markerChangeStartTime[id] + BLOCK_MARK_TIME)
+		{
+			markerState[id] = BlockMarkerState::None;
+		}
+		else
+		{
+			markerOpacity[id] = (float)(1.0 - (currentTime - markerChangeStartTime[id])/(double)BLOCK_MARK_TIME);
+		}
+	}
+	BlockState oldState = state[id];
+	if(BlockState::Moving == state[id])
+	{
+		if(currentTime > animationStartTime[id] + BLOCK_MOVE_TIME)
+		{
+			state[id] = BlockState::Normal;
+		}
+	}
+	if(BlockState::Disappearing == state[id])
+	{
+		if(currentTime > animationStartTime[id] + BLOCK_KILL_TIME)
+		{
+			state[id] = BlockState::Dead;
+		}
+	}
+	if(BlockState::Falling == state[id])
+	{
+		double t = (currentTime - animationStartTime[id]) * 0.001;
+		double s = FALL_ACCELERATION * t * t * 0.5;
+		int newY = (int)(animationFromScreenY[id] + s * BLOCK_SIZE_Y);
+		if(newY >= getScreenYPos(id))
+		{
+			state[id] = BlockState::Normal;
+		}
+	}
+	return state[id] != oldState;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::render(BlockID id, const unsigned int currentTime) const
+{
+	renderMarker(id);
+	if(BlockState::Normal == state[id])
+	{
+		renderNormal(id);
+	}
+	if(BlockState::Moving == state[id])
+	{
+		if(!moveOnTop[id])
+		{
+			renderMoving(id, currentTime);
+		}
+	}
+	if(BlockState::Disappearing == state[id])
+	{
+		renderDisappearing(id, currentTime);
+	}
+	if(BlockState::Falling == state[id])
+	{
+		renderFalling(id, currentTime);
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderOverlay(BlockID id, const unsigned int currentTime) const
+{
+	if(BlockState::Moving == state[id])
+	{
+		if(moveOnTop[id])
+		{
+			renderMoving(id, currentTime);
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderAll(const unsigned int currentTime) const
+{
+	for(BlockID id = 0; id < CAPACITY; ++id)
+	{
+		if(used[id])
+		{
+			render(id, currentTime);
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderAllOverlays(const unsigned int currentTime) const
+{
+	for(BlockID id = 0; id < CAPACITY; ++id)
+	{
+		if(used[id])
+		{
+			renderOverlay(id, currentTime);
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderMarker(BlockID id) const
+{
+	if(BlockMarkerState::None == markerState[id])
+	{
+		return;
+	}
+	int posX = getScreenXPos(id);
+	int posY = getScreenYPos(id);
+	renderer.setColor(255, 255, 255, (unsigned char)(255 * markerOpacity[id] * MAX_MARKER_OPACITY));
+	renderer.drawFilledRectangle(posX, posY, BLOCK_SIZE_X, BLOCK_SIZE_Y);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderNormal(BlockID id) const
+{
+	int posX = getScreenXPos(id);
+	int posY = getScreenYPos(id);
+
+	renderer.drawTextureCentered((TextureID)texture[id], posX, posY, BLOCK_SIZE_X, BLOCK_SIZE_Y);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderMoving(BlockID id, const unsigned int currentTime) const
+{
+	int destPosX = getScreenXPos(id);
+	int destPosY = getScreenYPos(id);
+
+	double lerpFactor = std::min(1.0, getAnimationTime(id, currentTime) / (double)BLOCK_MOVE_TIME);
+	int dx = (int)((destPosX - animationFromScreenX[id]) * lerpFactor);
+	int dy = (int)((destPosY - animationFromScreenY[id]) * lerpFactor);
+	int posX = animationFromScreenX[id] + dx;
+	int posY = animationFromScreenY[id] + dy;
+
+	renderer.drawTextureCentered((TextureID)texture[id], posX, posY, BLOCK_SIZE_X, BLOCK_SIZE_Y);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderDisappearing(BlockID id, const unsigned int currentTime) const
+{
+	double scalingFactor = std::max(0.0, 1.0 - getAnimationTime(id, currentTime) / (double)BLOCK_KILL_TIME);
+	int posX = getScreenXPos(id);
+	int posY = getScreenYPos(id);
+
+	renderer.drawTextureCentered((TextureID)texture[id], posX, posY, BLOCK_SIZE_X, BLOCK_SIZE_Y, scalingFactor);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBlockStore<Rows, Columns, Types>::renderFalling(BlockID id, const unsigned int currentTime) const
+{
+	double t = getAnimationTime(id, currentTime) * 0.001;
+	double s = FALL_ACCELERATION * t * t * 0.5;
+	int posX = getScreenXPos(id);
+	int posY = std::min(getScreenYPos(id), (int)(animationFromScreenY[id] + s * BLOCK_SIZE_Y));
+
+	renderer.drawTextureCentered((TextureID)texture[id], posX, posY, BLOCK_SIZE_X, BLOCK_SIZE_Y);
+}
+
+INSTANTIATE_BOARD_GEOMETRIES(class BasicBlockStore)
@@ -0,0 +1,123 @@
+#ifndef _BLOCK_STORE_H_
+#define _BLOCK_STORE_H_
+
+#include <cstdint>
+
+#include "Renderer.h"
+
+//blocks are referred to by index of their BlockStore slot
+typedef int BlockID;
+const BlockID NO_BLOCK = -1;
+
+const int BLOCK_SIZE_X = 42;
+const int BLOCK_SIZE_Y = 42;
+const int BOARD_POS_X = 330;
+const int BOARD_POS_Y = 105;
+
+struct NotImplementedException : public std::exception
+{
+};
+
+enum class BlockState : uint8_t
+{
+	Normal,
+	Moving,
+	Falling,
+	Disappearing,
+	Dead,
+};
+
+enum class BlockMarkerState : uint8_t
+{
+	None,
+	Marking,
+	Unmarking,
+	Marked
+};
+
+//state of all blocks of a board kept in per-field arrays indexed by BlockID,
+//so board wide passes touch only the fields they need
+template<int Rows, int Columns, int Types>
+class BasicBlockStore
+{
+public:
+	//every block occupies a board cell until it is removed
+	static const int CAPACITY = Rows * Columns;
+private:
+	Renderer			&renderer;
+
+	int					numFreeSlots;
+	BlockID				freeSlots[CAPACITY];
+
+	void moveTo(BlockID id, unsigned int currentTime, int newBoardX, int newBoardY, bool topLayer = false);
+
+	int getScreenXPos(BlockID id) const;
+	int getScreenYPos(BlockID id) const;
+	//milliseconds since animation start, 0 for times before it; rendering may
+	//happen between two ticks, before an animation started at the later one
+	unsigned int getAnimationTime(BlockID id, unsigned int currentTime) const;
+	void renderMarker(BlockID id) const;
+	void renderNormal(BlockID id) const;
+	void renderMoving(BlockID id, unsigned int currentTime) const;
+	void renderDisappearing(BlockID id, unsigned int currentTime) const;
+	void renderFalling(BlockID id, unsigned int currentTime) const;
+public:
+	bool				used[CAPACITY];
+	int8_t				boardX[CAPACITY];
+	int8_t				boardY[CAPACITY];
+	uint8_t				texture[CAPACITY];
+	BlockState			state[CAPACITY];
+
+	BlockMarkerState	markerState[CAPACITY];
+	bool				selected[CAPACITY];
+	float				markerOpacity[CAPACITY];
+	unsigned int		markerChangeStartTime[CAPACITY];
+
+	//moving, falling and disappearing are mutually exclusive so they share timing data
+	bool				moveOnTop[CAPACITY];
+	unsigned int		animationStartTime[CAPACITY];
+	int16_t				animationFromScreenX[CAPACITY];
+	int16_t				animationFromScreenY[CAPACITY];
+
+	BasicBlockStore(Renderer &r);
+
+	void clear();
+	BlockID create(int boardX, int boardY, TextureID texture);
+	void destroy(BlockID id);
+
+	bool isInside(BlockID id, int x, int y) const;
+	bool isSelected(BlockID id) const;
+	bool isDead(BlockID id) const;
+	bool canMove(BlockID id) const;
+	bool isNeighbor(BlockID id, BlockID block) const;
+
+	int getBoardX(BlockID id) const;
+	int getBoardY(BlockID id) const;
+	//return some numeric block type or -1 for empty/inactive block
+	int getType(BlockID id) const;
+	//return best swap direction given mouse coordinates
+	//sets (dx, dy) to one of (-1, 0), (1, 0), (0, -1), (0, 1)
+	void getSwapDirection(BlockID id, int x, int y, int &dx, int &dy) const;
+
+	void mark(BlockID id, unsigned int currentTime);
+	void unmark(BlockID id, unsigned int currentTime);
+	void select(BlockID id, unsigned int currentTime);
+	void unselect(BlockID id, unsigned int currentTime);
+
+	void swap(BlockID id, BlockID block, unsigned int currentTime);
+	void kill(BlockID id, unsigned int currentTime);
+	void fallTo(BlockID id, unsigned int currentTime, int targetX, int targetY);
+
+	//return true if block finished its animation (moving, falling or disappearing)
+	bool simulate(BlockID id, unsigned int currentTime);
+
+	void render(BlockID id, unsigned int currentTime) const;
+	void renderOverlay(BlockID id, unsigned int currentTime) const;
+	//draw all blocks in slot order
+	void renderAll(unsigned int currentTime) const;
+	void renderAllOverlays(unsigned int currentTime) const;
+};
+
+typedef BasicBlockStore<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> BlockStore;
+
+#endif
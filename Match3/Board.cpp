@@ -1,103 +1,323 @@
 #include "GameImpl.h"
 #include <ctime>
-#include <memory>
 
-Board::Board(Renderer &r) :
-renderer(r)
+template<int Rows, int Columns, int Types>
+BasicBoard<Rows, Columns, Types>::BasicBoard(Renderer &r) :
+store(r),
+mouseDownBlock(NO_BLOCK),
+version(0),
+simulatedVersion(0),
+animatingBlocks(0)
 {
 	rng.seed((unsigned int)std::time(0));
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			blocks[i][j] = NO_BLOCK;
+		}
+	}
+	blockTypes.clear();
+	bitBoard.clear();
+	hash = 0;
 }
 
-void Board::applyToAllBlocks(const std::function<void (BlockPtr&)> &f)
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::applyToAllBlocks(const std::function<void (BlockID)> &f)
 {
-	for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
+	for(BlockID id = 0; id < Store::CAPACITY; ++id)
 	{
-		for(int j = 0; j < NUM_BLOCK_COLUMNS; ++j)
+		if(!store.used[id])
 		{
-			if(!blocks[i][j])
-			{
-				continue;
-			}
-			f(blocks[i][j]);
+			continue;
 		}
+		f(id);
 	}
 }
 
-BlockPtr Board::findBlock(const std::function<bool (BlockPtr)> &predicate)
+template<int Rows, int Columns, int Types>
+BlockID BasicBoard<Rows, Columns, Types>::findBlock(const std::function<bool (BlockID)> &predicate) const
 {
-	for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
+	for(BlockID id = 0; id < Store::CAPACITY; ++id)
 	{
-		for(int j = 0; j < NUM_BLOCK_COLUMNS; ++j)
+		if(!store.used[id])
 		{
-			if(!blocks[i][j])
-			{
-				continue;
-			}
-			if(predicate(blocks[i][j]))
-			{
-				return blocks[i][j];
-			}
+			continue;
+		}
+		if(predicate(id))
+		{
+			return id;
 		}
 	}
-	return nullptr;
+	return NO_BLOCK;
 }
 
-void Board::generate()
+template<int Rows, int Columns, int Types>
+int BasicBoard<Rows, Columns, Types>::getBlockType(int x, int y) const
 {
-	std::uniform_int<>		block_dist(TID_BLOCK_1, TID_BLOCK_1 + NUM_BLOCK_TYPES - 1);
+	if(y < 0 || y >= Rows ||
+		x < 0 || x >= Columns)
+	{
+		return -1;
+	}
+	return blockTypes.get(x, y);
+}
 
-	for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::updateBlockType(int x, int y)
+{
+	int type = (blocks[y][x] != NO_BLOCK) ? store.getType(blocks[y][x]) : -1;
+	hash ^= ZobristT::key(x, y, blockTypes.get(x, y)) ^ ZobristT::key(x, y, type);
+	blockTypes.set(x, y, type);
+	bitBoard.setType(x, y, type);
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBoard<Rows, Columns, Types>::isKillingSwap(int srcX, int srcY, int dstX, int dstY) const
+{
+	return swapKillAt(dstX, dstY, srcX, srcY) || swapKillAt(srcX, srcY, dstX, dstY);
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBoard<Rows, Columns, Types>::swapKillAt(int x, int y, int fromX, int fromY) const
+{
+	int type = getBlockType(fromX, fromY);
+	if(type == -1)
 	{
-		for(int j = 0; j < NUM_BLOCK_COLUMNS; ++j)
+		return false;
+	}
+	//five cell windows centered at (x, y), as seen after the swap
+	int row[5];
+	int column[5];
+	for(int k = 0; k < 5; ++k)
+	{
+		int cx = x + k - 2;
+		int cy = y + k - 2;
+		row[k] = (cx == fromX && y == fromY) ? getBlockType(x, y) : getBlockType(cx, y);
+		column[k] = (x == fromX && cy == fromY) ? getBlockType(x, y) : getBlockType(x, cy);
+	}
+	row[2] = column[2] = type;
+	for(int base = 0; base <= 2; ++base)
+	{
+		if((row[base] == row[base + 1] && row[base + 1] == row[base + 2]) ||
+			(column[base] == column[base + 1] && column[base + 1] == column[base + 2]))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBoard<Rows, Columns, Types>::needsSimulation() const
+{
+	return version != simulatedVersion;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::markSimulated()
+{
+	simulatedVersion = version;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBoard<Rows, Columns, Types>::isSettled() const
+{
+	return !needsSimulation() && animatingBlocks == 0;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBoard<Rows, Columns, Types>::isStill() const
+{
+	if(!isSettled())
+	{
+		return false;
+	}
+	//markers start fading right on input, not only in simulateBlocks()
+	for(BlockID id = 0; id < Store::CAPACITY; ++id)
+	{
+		if(store.used[id] && (BlockMarkerState::Marking == store.markerState[id] ||
+			BlockMarkerState::Unmarking == store.markerState[id]))
 		{
-			BlockPtr block = std::make_shared<Block>(renderer);
-			block->init(j, i, (TextureID)block_dist(rng)); 
-			blocks[i][j] = block;
+			return false;
 		}
 	}
+	return true;
 }
 
-int Board::simulateKills(const unsigned int currentTime)
+template<int Rows, int Columns, int Types>
+bool BasicBoard<Rows, Columns, Types>::hasAnyMove() const
 {
-	KillCalculator killCalculator(*this);
+	return BasicMoveGenerator<Rows, Columns, Types>(bitBoard).hasAnyMove();
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBoard<Rows, Columns, Types>::countMoves() const
+{
+	return BasicMoveGenerator<Rows, Columns, Types>(bitBoard).countMoves();
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBoard<Rows, Columns, Types>::findHint(Move &move) const
+{
+	return BasicMoveGenerator<Rows, Columns, Types>(bitBoard).getHint(move);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::swapBlocks(const unsigned int currentTime, int srcX, int srcY, int dstX, int dstY)
+{
+	store.swap(blocks[srcY][srcX], blocks[dstY][dstX], currentTime);
+	std::swap(blocks[dstY][dstX], blocks[srcY][srcX]);
+	updateBlockType(srcX, srcY);
+	updateBlockType(dstX, dstY);
+	animatingBlocks += 2;
+	version++;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::simulateBlocks(const unsigned int currentTime)
+{
+	PROFILE_SCOPE("animations");
+	animatingBlocks = 0;
+	for(BlockID id = 0; id < Store::CAPACITY; ++id)
+	{
+		if(!store.used[id])
+		{
+			continue;
+		}
+		if(store.simulate(id, currentTime))
+		{
+			updateBlockType(store.boardX[id], store.boardY[id]);
+			version++;
+		}
+		if(!store.canMove(id))
+		{
+			animatingBlocks++;
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::generate()
+{
+	TypeGrid types;
+	BasicBoardGenerator<Rows, Columns, Types>(rng).generate(types);
+	createBlocks(types);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::createBlocks(const TypeGrid &types)
+{
+	store.clear();
+	mouseDownBlock = NO_BLOCK;
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			int type = types.get(j, i);
+			blocks[i][j] = (type != -1) ? store.create(j, i, (TextureID)type) : NO_BLOCK;
+			updateBlockType(j, i);
+		}
+	}
+	animatingBlocks = 0;
+	version++;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::saveState(State &state) const
+{
+	state.types.clear();
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			BlockID id = blocks[i][j];
+			if(id != NO_BLOCK && !store.isDead(id) && store.state[id] != BlockState::Disappearing)
+			{
+				state.types.set(j, i, store.texture[id]);
+			}
+		}
+	}
+	state.rng = rng;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::loadState(const State &state)
+{
+	rng = state.rng;
+	createBlocks(state.types);
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBoard<Rows, Columns, Types>::simulateKills(const unsigned int currentTime)
+{
+	PROFILE_SCOPE("kills");
+	BasicKillCalculator<Rows, Columns, Types> killCalculator(*this);
 	killCalculator.calculateKills();
 
 	int killCount = 0;
-	applyToAllBlocks([&] (BlockPtr b) {
-		if(killCalculator.hasKillAt(b->getBoardX(), b->getBoardY()))
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
 		{
-			b->kill(currentTime);
-			killCount++;
+			if(killCalculator.hasKillAt(j, i))
+			{
+				store.kill(blocks[i][j], currentTime);
+				updateBlockType(j, i);
+				killCount++;
+			}
 		}
-	});
+	}
+	if(killCount)
+	{
+		animatingBlocks += killCount;
+		version++;
+	}
 	return killCount;
 }
 
-void Board::removeDeadBlocks()
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::removeDeadBlocks()
 {
-	applyToAllBlocks([] (BlockPtr &b) {
-		if(b->isDead())
+	PROFILE_SCOPE("removeDeadBlocks");
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
 		{
-			b = nullptr;
+			BlockID id = blocks[i][j];
+			if(id == NO_BLOCK || !store.isDead(id))
+			{
+				continue;
+			}
+			//slot may be reused right away, so don't keep referring to it
+			if(id == mouseDownBlock)
+			{
+				mouseDownBlock = NO_BLOCK;
+			}
+			store.destroy(id);
+			blocks[i][j] = NO_BLOCK;
+			version++;
 		}
-	});
+	}
 }
 
-void Board::simulateFalling(const unsigned int currentTime)
+template<int Rows, int Columns, int Types>
+void BasicBoard<Rows, Columns, Types>::simulateFalling(const unsigned int currentTime)
 {
-	std::uniform_int<>		block_dist(TID_BLOCK_1, TID_BLOCK_1 + NUM_BLOCK_TYPES - 1);
-	int numBlocksGenerated[NUM_BLOCK_COLUMNS];
-	for(int i = 0; i < NUM_BLOCK_COLUMNS; ++i)
+	PROFILE_SCOPE("falling");
+	std::uniform_int_distribution<int> block_dist(TID_BLOCK_1, TID_BLOCK_1 + Types - 1);
+	int numBlocksGenerated[Columns];
+	for(int i = 0; i < Columns; ++i)
 	{
 		numBlocksGenerated[i] = 0;
 	}
-	for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
+	for(int i = 0; i < Rows; ++i)
 	{
-		for(int j = 0; j < NUM_BLOCK_COLUMNS; ++j)
+		for(int j = 0; j < Columns; ++j)
 		{
 
-			int reverseRowIndex = NUM_BLOCK_ROWS - i - 1;
-			if(blocks[reverseRowIndex][j])
+			int reverseRowIndex = Rows - i - 1;
+			if(blocks[reverseRowIndex][j] != NO_BLOCK)
 			{
 				continue;
 			}
@@ -106,11 +326,11 @@ void Board::simulateFalling(const unsigned int currentTime)
 			int testRow;
 			for(testRow = reverseRowIndex - 1; testRow >= 0; --testRow)
 			{
-				if(!blocks[testRow][j])
+				if(blocks[testRow][j] == NO_BLOCK)
 				{
 					continue;
 				}
-				if(blocks[testRow][j]->canMove())
+				if(store.canMove(blocks[testRow][j]))
 				{
 					blockFound = true;
 					break;
@@ -118,19 +338,26 @@ void Board::simulateFalling(const unsigned int currentTime)
 			}
 			if(blockFound)
 			{
-				blocks[testRow][j]->fallTo(currentTime, j, reverseRowIndex);
+				store.fallTo(blocks[testRow][j], currentTime, j, reverseRowIndex);
 				blocks[reverseRowIndex][j] = blocks[testRow][j];
-				blocks[testRow][j] = nullptr;
+				blocks[testRow][j] = NO_BLOCK;
+				updateBlockType(j, testRow);
+				animatingBlocks++;
+				version++;
 			}
 			else if(testRow == -1)
 			{
 				//generate new
-				BlockPtr block(new Block(renderer));
-				block->init(j, -(numBlocksGenerated[j] + 1), (TextureID)block_dist(rng));
+				BlockID block = store.create(j, -(numBlocksGenerated[j] + 1), (TextureID)block_dist(rng));
 				numBlocksGenerated[j]++;
-				block->fallTo(currentTime, j, reverseRowIndex);
+				store.fallTo(block, currentTime, j, reverseRowIndex);
 				blocks[reverseRowIndex][j] = block;
+				animatingBlocks++;
+				version++;
 			}
+			updateBlockType(j, reverseRowIndex);
 		}
 	}
 }
+
+INSTANTIATE_BOARD_GEOMETRIES(struct BasicBoard)
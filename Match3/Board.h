@@ -1,42 +1,108 @@
 #ifndef _BOARD_H_
 #define _BOARD_H_
 
-template<typename SrcT, typename DstT>
-void mapTable(SrcT mapFrom[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS],
-			  DstT mapTo[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS],
+template<int Rows, int Columns, typename SrcT, typename DstT>
+void mapTable(const SrcT (&mapFrom)[Rows][Columns],
+			  DstT (&mapTo)[Rows][Columns],
 			  const std::function<DstT (const SrcT&)> &f)
 {
-	for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
+	for(int i = 0; i < Rows; ++i)
 	{
-		for(int j = 0; j < NUM_BLOCK_COLUMNS; ++j)
+		for(int j = 0; j < Columns; ++j)
 		{
 			mapTo[i][j] = f(mapFrom[i][j]);
 		}
 	}
 }
 
-struct Board
+//swap of two neighbor blocks
+struct Move
 {
-	Renderer				&renderer;
-	std::mt19937			rng;
+	int						srcX;
+	int						srcY;
+	int						dstX;
+	int						dstY;
+};
+
+template<int Rows, int Columns, int Types>
+struct BasicBoard
+{
+	typedef BasicBlockStore<Rows, Columns, Types>	Store;
+	typedef PackedTypeGrid<Rows, Columns, Types>	TypeGrid;
+	typedef BasicBitBoard<Rows, Columns, Types>		BitBoardT;
+	typedef BasicBoardState<Rows, Columns, Types>	State;
+	typedef BasicZobrist<Rows, Columns, Types>		ZobristT;
+
+	Store					store;
+	BoardRng				rng;
+
+	//block occupying every cell or NO_BLOCK
+	BlockID					blocks[Rows][Columns];
+	BlockID					mouseDownBlock;
+	//cached BlockStore::getType() of every cell (-1 for empty cells),
+	//updated whenever board or block state changes
+	TypeGrid				blockTypes;
+	//the same types as one mask per type
+	BitBoardT				bitBoard;
+	//Zobrist hash of blockTypes
+	uint64_t				hash;
 
-	BlockPtr				blocks[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS];
-	BlockPtr				mouseDownBlock;
+	//bumped on every swap, kill, fall, spawn and finished animation
+	unsigned int			version;
+	//version seen by last kill/fall pass
+	unsigned int			simulatedVersion;
+	//number of blocks that are moving, falling or disappearing
+	int						animatingBlocks;
 
-	Board(Renderer &renderer);
+	BasicBoard(Renderer &renderer);
 
-	void applyToAllBlocks(const std::function<void (BlockPtr&)> &f);
-	BlockPtr findBlock(const std::function<bool (BlockPtr)> &predicate);
+	//both walk the block store linearly, not in board order
+	void applyToAllBlocks(const std::function<void (BlockID)> &f);
+	BlockID findBlock(const std::function<bool (BlockID)> &predicate) const;
+
+	int getBlockType(int x, int y) const;
+	void updateBlockType(int x, int y);
+	//check if swapping two neighbor blocks creates a kill, only rows
+	//and columns of swapped blocks are examined
+	bool isKillingSwap(int srcX, int srcY, int dstX, int dstY) const;
+	bool swapKillAt(int x, int y, int fromX, int fromY) const;
+	//new static blocks of given types
+	void createBlocks(const TypeGrid &types);
+
+	//kill/fall pass can only change something if board changed since last pass
+	bool needsSimulation() const;
+	void markSimulated();
+	//no animations in progress and nothing left to kill or fall
+	bool isSettled() const;
+	//settled and no marker is fading either, so the board looks the same until input arrives
+	bool isStill() const;
+
+	//killing swaps available right now, see BasicMoveGenerator
+	bool hasAnyMove() const;
+	int countMoves() const;
+	//false if there are no moves
+	bool findHint(Move &move) const;
 
 	template<typename T>
-	void mapBlocks(T mapTo[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS],
-		const std::function<T (const BlockPtr&)> &f) const
+	void mapBlocks(T (&mapTo)[Rows][Columns],
+		const std::function<T (const BlockID&)> &f) const
 	{
-		mapTable<const BlockPtr, T>(blocks, mapTo, f);
+		mapTable<Rows, Columns, BlockID, T>(blocks, mapTo, f);
 	}
 
+//snapshots
+	//blocks still moving or falling are saved as already settled,
+	//disappearing ones as empty cells
+	void saveState(State &state) const;
+	//replaces all blocks, animations and selection are dropped
+	void loadState(const State &state);
+
 //board logic
+	//new board without kills and with at least one move
 	void generate();
+	void swapBlocks(unsigned int currentTime, int srcX, int srcY, int dstX, int dstY);
+	//advance block animations
+	void simulateBlocks(unsigned int currentTime);
 	//return number of blocks killed
 	int simulateKills(unsigned int currentTime);
 	void removeDeadBlocks();
@@ -44,6 +110,7 @@ struct Board
 	void simulateFalling(unsigned int currentTime);
 };
 
+typedef BasicBoard<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> Board;
 typedef std::shared_ptr<Board> BoardPtr;
 
-#endif
\ No newline at end of file
+#endif
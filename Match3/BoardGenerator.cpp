@@ -0,0 +1,256 @@
+#include "GameImpl.h"
+#include <cstring>
+
+template<int Rows, int Columns, int Types>
+BasicBoardGenerator<Rows, Columns, Types>::BasicBoardGenerator(BoardRng &r) :
+rng(r),
+entropy(0),
+entropyUsed(ENTROPY_LIMIT)
+{
+	for(int allowed = 0; allowed < (1 << Types); ++allowed)
+	{
+		choiceCounts[allowed] = 0;
+		for(int type = 0; type < Types; ++type)
+		{
+			if(allowed & (1 << type))
+			{
+				choices[allowed][choiceCounts[allowed]++] = (int8_t)type;
+			}
+		}
+	}
+	for(int i = 0; i < Rows + 2 * BORDER; ++i)
+	{
+		for(int j = 0; j < Columns + 2 * BORDER; ++j)
+		{
+			cells[i][j] = 0;
+		}
+	}
+	memset(bulkCells, 0, sizeof(bulkCells));
+	for(int bits = 0; bits < (1 << Types); ++bits)
+	{
+		bitValues[bits] = 0;
+	}
+	for(int type = 0; type < Types; ++type)
+	{
+		bitValues[1 << type] = (int8_t)(type + 1);
+	}
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBoardGenerator<Rows, Columns, Types>::allowedTypes(int x, int y) const
+{
+	//pairs of decided cells next to (x, y) that a third block would join:
+	//both on one side or one on each side; undecided cells are 0 and
+	//forbid nothing, so the padding needs no bounds checks
+	const int STRIDE = Columns + 2 * BORDER;
+	const int8_t *c = &cells[y + BORDER][x + BORDER];
+	int forbidden = pairType(c[-2], c[-1]) | pairType(c[-1], c[1]) | pairType(c[1], c[2]) |
+		pairType(c[-2 * STRIDE], c[-STRIDE]) | pairType(c[-STRIDE], c[STRIDE]) | pairType(c[STRIDE], c[2 * STRIDE]);
+	return ((1 << Types) - 1) & ~forbidden;
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBoardGenerator<Rows, Columns, Types>::pickType(int allowed)
+{
+	const uint32_t count = (uint32_t)choiceCounts[allowed];
+	uint32_t index = 0;
+	if(count > 1)
+	{
+		if(entropyUsed * count > ENTROPY_LIMIT)
+		{
+			entropy = (uint32_t)rng();
+			entropyUsed = 1;
+		}
+		//scale the draw to the number of choices instead of rejecting
+		//draws, the low half is what is left for next picks
+		uint64_t scaled = (uint64_t)entropy * count;
+		index = (uint32_t)(scaled >> 32);
+		entropy = (uint32_t)scaled;
+		entropyUsed *= count;
+	}
+	return choices[allowed][index];
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoardGenerator<Rows, Columns, Types>::plantMove(PlantedMove &move)
+{
+	//"t t _ t" or "t _ t t" along a row or a column, swapping the gap
+	//with the lone block lines up three
+	const uint32_t r = (uint32_t)rng();
+	const bool vertical = (r & 1) != 0;
+	const bool mirrored = (r & 2) != 0;
+	const int length = vertical ? Rows : Columns;
+	const int breadth = vertical ? Columns : Rows;
+	const int along = (int)(((uint64_t)(r >> 2) * (uint64_t)(length - 3)) >> 30);
+	const int across = (int)(((uint64_t)(uint32_t)rng() * (uint64_t)breadth) >> 32);
+	move.type = (int)(((uint64_t)(uint32_t)rng() * (uint64_t)Types) >> 32);
+	static const int PATTERN[2][3] = { { 0, 1, 3 }, { 0, 2, 3 } };
+	for(int i = 0; i < 3; ++i)
+	{
+		int offset = along + PATTERN[mirrored][i];
+		move.x[i] = vertical ? across : offset;
+		move.y[i] = vertical ? offset : across;
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoardGenerator<Rows, Columns, Types>::fill()
+{
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			cells[i + BORDER][j + BORDER] = 0;
+		}
+	}
+	PlantedMove move;
+	plantMove(move);
+	for(int i = 0; i < 3; ++i)
+	{
+		cells[move.y[i] + BORDER][move.x[i] + BORDER] = (int8_t)(move.type + 1);
+	}
+	//planted cells are taken into account on every side, so no run can
+	//form around them either
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			int8_t &cell = cells[i + BORDER][j + BORDER];
+			if(!cell)
+			{
+				cell = (int8_t)(pickType(allowedTypes(j, i)) + 1);
+			}
+		}
+	}
+}
+
+//64 bits at p, alignment and aliasing safe
+static inline uint64_t loadWord(const uint8_t *p)
+{
+	uint64_t word;
+	memcpy(&word, p, sizeof(word));
+	return word;
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoardGenerator<Rows, Columns, Types>::fillBulk()
+{
+	for(int k = 0; k < BULK_LANES; ++k)
+	{
+		for(int i = 0; i < Rows; ++i)
+		{
+			memset(bulkCells[k][i + BORDER], 0, BULK_STRIDE);
+		}
+		PlantedMove move;
+		plantMove(move);
+		for(int i = 0; i < 3; ++i)
+		{
+			bulkCells[k][move.y[i] + BORDER][move.x[i] + BORDER] = (uint8_t)(1 << move.type);
+		}
+	}
+
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int k = 0; k < BULK_LANES; ++k)
+		{
+			const uint8_t *row = bulkCells[k][i + BORDER];
+			//rows below hold planted cells only, the same goes for cells
+			//to the right; reads past the row end land in the zero left
+			//border of the next row
+			for(int w = 0; w < BULK_STRIDE; w += 8)
+			{
+				const uint64_t up2 = loadWord(row - 2 * BULK_STRIDE + w);
+				const uint64_t up1 = loadWord(row - BULK_STRIDE + w);
+				const uint64_t down1 = loadWord(row + BULK_STRIDE + w);
+				const uint64_t down2 = loadWord(row + 2 * BULK_STRIDE + w);
+				const uint64_t right1 = loadWord(row + w + 1);
+				const uint64_t right2 = loadWord(row + w + 2);
+				const uint64_t forbidden = (up2 & up1) | (up1 & down1) | (down1 & down2) | (right1 & right2);
+				memcpy(bulkForbidden[k] + w, &forbidden, sizeof(forbidden));
+			}
+
+			//16 bits of a draw per pick keep every choice within 0.01% of
+			//uniform, like pickType(), with no branch on running out of bits
+			for(int j = 0; j < Columns; j += 2)
+			{
+				const uint32_t r = (uint32_t)rng();
+				bulkEntropy[k][j] = (uint16_t)r;
+				bulkEntropy[k][j + 1] = (uint16_t)(r >> 16);
+			}
+		}
+
+		//only the cells to the left depend on picks of this row
+		uint8_t left2[BULK_LANES] = {};
+		uint8_t left1[BULK_LANES] = {};
+		for(int j = 0; j < Columns; ++j)
+		{
+			for(int k = 0; k < BULK_LANES; ++k)
+			{
+				uint8_t &cell = bulkCells[k][i + BORDER][j + BORDER];
+				if(!cell)
+				{
+					const int forbidden = bulkForbidden[k][j + BORDER] | (left2[k] & left1[k]) |
+						(left1[k] & bulkCells[k][i + BORDER][j + BORDER + 1]);
+					const int allowed = ALL_TYPES & ~forbidden;
+					const uint32_t index = ((uint32_t)bulkEntropy[k][j] * (uint32_t)choiceCounts[allowed]) >> 16;
+					cell = (uint8_t)(1 << choices[allowed][index]);
+				}
+				left2[k] = left1[k];
+				left1[k] = cell;
+			}
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoardGenerator<Rows, Columns, Types>::generate(TypeGrid &grid)
+{
+	fill();
+	grid.clear();
+	int cell = 0;
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j, ++cell)
+		{
+			grid.words[cell / TypeGrid::CELLS_PER_WORD] |=
+				(uint64_t)cells[i + BORDER][j + BORDER] << ((cell % TypeGrid::CELLS_PER_WORD) * TypeGrid::BITS_PER_CELL);
+		}
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicBoardGenerator<Rows, Columns, Types>::generate(TypeGrid *grids, int count)
+{
+	//a last partial group is filled whole, extra boards are dropped
+	for(int n = 0; n < count; n += BULK_LANES)
+	{
+		fillBulk();
+		for(int k = 0; k < BULK_LANES && n + k < count; ++k)
+		{
+			//words are put together in a register and stored once
+			TypeGrid &grid = grids[n + k];
+			uint64_t word = 0;
+			int wordIndex = 0;
+			int cellsInWord = 0;
+			for(int i = 0; i < Rows; ++i)
+			{
+				for(int j = 0; j < Columns; ++j)
+				{
+					word |= (uint64_t)bitValues[bulkCells[k][i + BORDER][j + BORDER]] << (cellsInWord * TypeGrid::BITS_PER_CELL);
+					if(++cellsInWord == TypeGrid::CELLS_PER_WORD)
+					{
+						grid.words[wordIndex++] = word;
+						word = 0;
+						cellsInWord = 0;
+					}
+				}
+			}
+			if(cellsInWord)
+			{
+				grid.words[wordIndex] = word;
+			}
+		}
+	}
+}
+
+INSTANTIATE_BOARD_GEOMETRIES(class BasicBoardGenerator)
@@ -0,0 +1,86 @@
+#ifndef _BOARD_GENERATOR_H_
+#define _BOARD_GENERATOR_H_
+
+//builds starting positions constructively: one killing swap is planted first,
+//then every other cell gets a random type among those that don't complete a
+//run with already placed neighbors, so there is nothing to kill and at least
+//one move without any retries
+template<int Rows, int Columns, int Types>
+class BasicBoardGenerator
+{
+	//planted move needs one free type around it besides the worst case
+	//of three forbidden ones
+	static_assert(Types >= 4, "constructive generation needs at least 4 block types");
+	static_assert(Rows >= 4 && Columns >= 4, "planted move needs 4 cells in a row");
+	static_assert(Types <= 8, "bulk mode keeps a type bit per cell in a byte");
+
+	typedef PackedTypeGrid<Rows, Columns, Types>	TypeGrid;
+
+	//cells are padded with 2 empty cells on every side
+	static const int BORDER = 2;
+	//at most 16 bits of every draw are used, so the remaining precision
+	//keeps every choice within 0.01% of uniform
+	static const uint32_t ENTROPY_LIMIT = 1 << 16;
+	//bulk mode rows are padded to whole 64 bit words
+	static const int BULK_STRIDE = (Columns + 2 * BORDER + 7) & ~7;
+	//boards filled side by side in bulk mode, so that the left to right
+	//dependency chains of independent boards overlap
+	static const int BULK_LANES = 4;
+	static const int ALL_TYPES = (1 << Types) - 1;
+
+	//"t t _ t" or "t _ t t" pattern: cell coordinates and type index
+	struct PlantedMove
+	{
+		int					x[3];
+		int					y[3];
+		int					type;
+	};
+
+	BoardRng				&rng;
+	//one rng draw serves several picks, entropyUsed is the product of
+	//choice counts taken from it so far
+	uint32_t				entropy;
+	uint32_t				entropyUsed;
+	//0 for cells not decided yet, otherwise type index + 1 (the same
+	//encoding PackedTypeGrid uses)
+	int8_t					cells[Rows + 2 * BORDER][Columns + 2 * BORDER];
+	//allowed type set -> number of types and the types themselves
+	int8_t					choiceCounts[1 << Types];
+	int8_t					choices[1 << Types][Types];
+	//bulk mode keeps every cell as the bit of its type (0 while not
+	//decided), so checking a pair is a single and and the checks that
+	//don't depend on cells of the same row are done for a whole row
+	//at once with word operations
+	uint8_t					bulkCells[BULK_LANES][Rows + 2 * BORDER][BULK_STRIDE];
+	//checks of current row against rows above and below and the cells
+	//to the right, per cell
+	uint8_t					bulkForbidden[BULK_LANES][BULK_STRIDE];
+	//one rng draw per two picks in bulk mode, see fillBulk()
+	uint16_t				bulkEntropy[BULK_LANES][Columns + 1];
+	//type bit -> type index + 1
+	int8_t					bitValues[1 << Types];
+
+	//type bit of a and b if they are the same decided type
+	static int pairType(int a, int b)
+	{
+		return ((1 << a) >> 1) & -(int)(a == b);
+	}
+	//bit i set if type index i doesn't complete a run at (x, y)
+	int allowedTypes(int x, int y) const;
+	//uniform choice among allowed types
+	int pickType(int allowed);
+	void plantMove(PlantedMove &move);
+	void fill();
+	//fills BULK_LANES boards
+	void fillBulk();
+public:
+	BasicBoardGenerator(BoardRng &r);
+
+	void generate(TypeGrid &grid);
+	//bulk mode for level pools
+	void generate(TypeGrid *grids, int count);
+};
+
+typedef BasicBoardGenerator<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> BoardGenerator;
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef _BOARD_STATE_H_
+#define _BOARD_STATE_H_
+
+#include <cstdint>
+#include <type_traits>
+
+//random generator driving block spawns (PCG32, O'Neill), the whole state is
+//one 64 bit word so boards can be cloned together with their future
+class BoardRng
+{
+	static const uint64_t MULTIPLIER = 6364136223846793005ull;
+	static const uint64_t INCREMENT = 1442695040888963407ull;
+
+	uint64_t				state;
+public:
+	typedef uint32_t		result_type;
+
+	BoardRng(uint64_t s = 0)
+	{
+		seed(s);
+	}
+
+	void seed(uint64_t s)
+	{
+		state = 0;
+		(*this)();
+		state += s;
+		(*this)();
+	}
+
+	static constexpr result_type min()
+	{
+		return 0;
+	}
+
+	static constexpr result_type max()
+	{
+		return 0xffffffffu;
+	}
+
+	result_type operator()()
+	{
+		uint64_t old = state;
+		state = old * MULTIPLIER + INCREMENT;
+		uint32_t shifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+		uint32_t rotation = (uint32_t)(old >> 59);
+		return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+	}
+
+	friend bool operator==(const BoardRng &a, const BoardRng &b)
+	{
+		return a.state == b.state;
+	}
+
+	friend bool operator!=(const BoardRng &a, const BoardRng &b)
+	{
+		return a.state != b.state;
+	}
+};
+
+//everything needed to continue a board: block types and spawn rng, copied
+//with plain memcpy (40 bytes for 8x8 with 5 types); animations are not part
+//of the state
+template<int Rows, int Columns, int Types>
+struct BasicBoardState
+{
+	PackedTypeGrid<Rows, Columns, Types>	types;
+	BoardRng								rng;
+};
+
+static_assert(std::is_trivially_copyable<BoardRng>::value, "board rng must be trivially copyable");
+static_assert(std::is_trivially_copyable<BasicBoardState<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES>>::value, "board state must be trivially copyable");
+
+#endif
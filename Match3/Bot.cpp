@@ -0,0 +1,209 @@
+#include "GameImpl.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+BotOptions::BotOptions() :
+threads(0),
+timeBudget(5000),
+nodeBudget(0),
+depth(2),
+tableSize(16)
+{
+}
+
+double BotStats::getNodesPerSecond() const
+{
+	return seconds > 0 ? nodes / seconds : 0;
+}
+
+template<int Rows, int Columns, int Types>
+BasicBot<Rows, Columns, Types>::BasicBot(const BotOptions &o) :
+options(o)
+{
+	if(options.threads <= 0)
+	{
+		options.threads = (int)std::thread::hardware_concurrency();
+	}
+	if(options.threads <= 0)
+	{
+		options.threads = 1;
+	}
+	if(options.depth < 1)
+	{
+		options.depth = 1;
+	}
+	if(options.tableSize > 0)
+	{
+		table = std::unique_ptr<TranspositionTable>(new TranspositionTable(options.tableSize));
+	}
+}
+
+template<int Rows, int Columns, int Types>
+int BasicBot<Rows, Columns, Types>::evaluate(const TypeGrid &board, const BitBoardT &bitBoard, uint64_t hash,
+											 int depth, BoardRng &rng, long long &nodes) const
+{
+	if(depth <= 0)
+	{
+		return 0;
+	}
+	uint64_t key = 0;
+	if(table)
+	{
+		//separate slots for every depth
+		key = hash + (uint64_t)depth * 0x9e3779b97f4a7c15ull;
+		TranspositionEntry entry;
+		if(table->probe(key, entry) && entry.depth == depth)
+		{
+			return entry.value;
+		}
+	}
+	Move moves[Generator::MAX_MOVES];
+	const int count = Generator(bitBoard).getMoves(moves);
+	int best = 0;
+	typename Resolver::Result result;
+	for(int i = 0; i < count; ++i)
+	{
+		//one sampled refill per move, averaging happens at the root
+		Resolver::resolve(board, hash, moves[i], rng, result);
+		nodes++;
+		const int value = result.score + evaluate(result.board, result.bitBoard, result.hash, depth - 1, rng, nodes);
+		if(value > best)
+		{
+			best = value;
+		}
+	}
+	if(table)
+	{
+		TranspositionEntry entry;
+		entry.value = best;
+		entry.move = 0;
+		entry.depth = (uint8_t)depth;
+		table->store(key, entry);
+	}
+	return best;
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicBot<Rows, Columns, Types>::findMove(const TypeGrid &board, uint64_t hash, unsigned int seed, Move &move,
+											 BotStats *stats) const
+{
+	typedef std::chrono::steady_clock clock;
+	const clock::time_point startTime = clock::now();
+	const clock::time_point deadline = startTime + std::chrono::microseconds(options.timeBudget);
+
+	BitBoardT bitBoard;
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			bitBoard.setType(j, i, board.get(j, i));
+		}
+	}
+	Move rootMoves[Generator::MAX_MOVES];
+	const int numRootMoves = Generator(bitBoard).getMoves(rootMoves);
+	if(!numRootMoves)
+	{
+		return false;
+	}
+	if(table)
+	{
+		table->newSearch();
+	}
+
+	struct WorkerResult
+	{
+		long long			sums[Generator::MAX_MOVES];
+		int					counts[Generator::MAX_MOVES];
+		long long			nodes;
+	};
+	std::vector<WorkerResult> results(options.threads);
+	std::atomic<long long> totalNodes(0);
+
+	auto worker = [&] (int index) {
+		WorkerResult &r = results[index];
+		BoardRng rng(((uint64_t)seed << 32) | (uint64_t)index);
+		typename Resolver::Result result;
+		r.nodes = 0;
+		for(int i = 0; i < numRootMoves; ++i)
+		{
+			r.sums[i] = 0;
+			r.counts[i] = 0;
+		}
+		//workers start at different root moves so short searches still
+		//spread over all of them
+		int rootIndex = (index * numRootMoves) / options.threads;
+		for(int sample = 0; ; ++sample)
+		{
+			//first worker always samples every root move at least once
+			if(index != 0 || sample >= numRootMoves)
+			{
+				if(options.timeBudget && clock::now() >= deadline)
+				{
+					break;
+				}
+				if(options.nodeBudget && totalNodes.load(std::memory_order_relaxed) >= options.nodeBudget)
+				{
+					break;
+				}
+			}
+			long long nodes = 1;
+			Resolver::resolve(board, hash, rootMoves[rootIndex], rng, result);
+			r.sums[rootIndex] += result.score + evaluate(result.board, result.bitBoard, result.hash,
+														 options.depth - 1, rng, nodes);
+			r.counts[rootIndex]++;
+			r.nodes += nodes;
+			totalNodes.fetch_add(nodes, std::memory_order_relaxed);
+			if(++rootIndex == numRootMoves)
+			{
+				rootIndex = 0;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for(int i = 1; i < options.threads; ++i)
+	{
+		threads.push_back(std::thread(worker, i));
+	}
+	worker(0);
+	for(auto &t : threads)
+	{
+		t.join();
+	}
+
+	//merge root statistics of all workers, pick best average
+	int best = 0;
+	double bestValue = -1;
+	long long samples = 0;
+	for(int i = 0; i < numRootMoves; ++i)
+	{
+		long long sum = 0;
+		long long count = 0;
+		for(const WorkerResult &r : results)
+		{
+			sum += r.sums[i];
+			count += r.counts[i];
+		}
+		samples += count;
+		double value = count ? (double)sum / count : 0;
+		if(value > bestValue)
+		{
+			bestValue = value;
+			best = i;
+		}
+	}
+	move = rootMoves[best];
+
+	if(stats)
+	{
+		stats->nodes = totalNodes.load();
+		stats->samples = samples;
+		stats->rootMoves = numRootMoves;
+		stats->seconds = std::chrono::duration<double>(clock::now() - startTime).count();
+	}
+	return true;
+}
+
+INSTANTIATE_BOARD_GEOMETRIES(class BasicBot)
@@ -0,0 +1,69 @@
+#ifndef _BOT_H_
+#define _BOT_H_
+
+struct BotOptions
+{
+	//0 means one per hardware thread
+	int						threads;
+	//search time per move in microseconds, 0 for no limit (nodeBudget
+	//must be set then)
+	unsigned int			timeBudget;
+	//stop after this many nodes even if there is time left, 0 for no limit;
+	//single threaded searches limited by nodes are reproducible
+	long long				nodeBudget;
+	//moves searched ahead, including the move being chosen
+	int						depth;
+	//transposition table size in megabytes shared by all searches of
+	//the bot, 0 to disable; cached values make results depend on what
+	//was searched before
+	int						tableSize;
+
+	BotOptions();
+};
+
+struct BotStats
+{
+	//cascades resolved during search
+	long long				nodes;
+	//chance outcomes sampled for root moves
+	long long				samples;
+	int						rootMoves;
+	double					seconds;
+
+	double getNodesPerSecond() const;
+};
+
+//expectimax player over packed boards: swaps are decision nodes, block
+//refills are chance nodes sampled with the bot's own rng (the real board
+//rng is never peeked); root parallel, every thread samples all root moves
+//and their averages are merged when the budget runs out
+template<int Rows, int Columns, int Types>
+class BasicBot
+{
+	typedef PackedTypeGrid<Rows, Columns, Types>		TypeGrid;
+	typedef BasicMoveGenerator<Rows, Columns, Types>	Generator;
+	typedef BasicCascadeResolver<Rows, Columns, Types>	Resolver;
+	typedef BasicBitBoard<Rows, Columns, Types>			BitBoardT;
+	typedef BasicZobrist<Rows, Columns, Types>			ZobristT;
+
+	BotOptions				options;
+	//positions reached again (same refills, different move order) are
+	//evaluated once
+	std::unique_ptr<TranspositionTable>	table;
+
+	//best sampled score of depth more moves; hash is the Zobrist hash of
+	//board, carried down from the resolver instead of recomputed per node
+	int evaluate(const TypeGrid &board, const BitBoardT &bitBoard, uint64_t hash, int depth,
+				 BoardRng &rng, long long &nodes) const;
+public:
+	BasicBot(const BotOptions &o);
+
+	//hash is the Zobrist hash of board, as kept by Board::hash; false if
+	//board has no moves; safe to call from several threads
+	bool findMove(const TypeGrid &board, uint64_t hash, unsigned int seed, Move &move,
+				  BotStats *stats = nullptr) const;
+};
+
+typedef BasicBot<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> Bot;
+
+#endif
@@ -0,0 +1,117 @@
+#include "GameImpl.h"
+#include <cstdlib>
+
+template<int Rows, int Columns, int Types>
+bool BasicCascadeResolver<Rows, Columns, Types>::resolve(const TypeGrid &board, uint64_t hash, const Move &swap,
+														 BoardRng &rng, Result &result)
+{
+	typedef typename BitBoardT::Ops Ops;
+
+	result.board = board;
+	result.hash = hash;
+	result.score = 0;
+	result.depth = 0;
+	result.kills = 0;
+
+	if(std::abs(swap.srcX - swap.dstX) + std::abs(swap.srcY - swap.dstY) != 1 ||
+		board.get(swap.srcX, swap.srcY) == -1 ||
+		board.get(swap.dstX, swap.dstY) == -1)
+	{
+		return false;
+	}
+
+	int cells[Rows][Columns];
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			cells[i][j] = board.get(j, i);
+		}
+	}
+	//every cell write goes through here so hash stays that of cells
+	auto setCell = [&] (int x, int y, int type) {
+		hash ^= ZobristT::key(x, y, cells[y][x]) ^ ZobristT::key(x, y, type);
+		cells[y][x] = type;
+	};
+	const int srcType = cells[swap.srcY][swap.srcX];
+	setCell(swap.srcX, swap.srcY, cells[swap.dstY][swap.dstX]);
+	setCell(swap.dstX, swap.dstY, srcType);
+
+	std::uniform_int_distribution<int> block_dist(TID_BLOCK_1, TID_BLOCK_1 + Types - 1);
+	BitBoardT bitBoard;
+	for(;;)
+	{
+		bitBoard.clear();
+		for(int i = 0; i < Rows; ++i)
+		{
+			for(int j = 0; j < Columns; ++j)
+			{
+				if(cells[i][j] != -1)
+				{
+					bitBoard.typeMasks[cells[i][j] - TID_BLOCK_1] |= BitBoardT::cellMask(j, i);
+				}
+			}
+		}
+		const Mask kills = bitBoard.findKills();
+		if(Ops::isZero(kills))
+		{
+			break;
+		}
+		const int killCount = Ops::popCount(kills);
+		result.score += killScore(killCount);
+		result.kills += killCount;
+		if(result.depth < MAX_RECORDED_STEPS)
+		{
+			result.steps[result.depth] = kills;
+		}
+		result.depth++;
+
+		//surviving blocks fall to the bottom of their columns
+		int numSpawned[Columns];
+		for(int j = 0; j < Columns; ++j)
+		{
+			int dstRow = Rows - 1;
+			for(int i = Rows - 1; i >= 0; --i)
+			{
+				if(cells[i][j] != -1 && Ops::isZero(kills & BitBoardT::cellMask(j, i)))
+				{
+					if(dstRow != i)
+					{
+						setCell(j, dstRow, cells[i][j]);
+					}
+					dstRow--;
+				}
+			}
+			numSpawned[j] = dstRow + 1;
+		}
+		//new blocks fill the gaps left on top, bottom row first
+		for(int i = Rows - 1; i >= 0; --i)
+		{
+			for(int j = 0; j < Columns; ++j)
+			{
+				if(i < numSpawned[j])
+				{
+					setCell(j, i, block_dist(rng));
+				}
+			}
+		}
+	}
+
+	if(!result.depth)
+	{
+		return false;
+	}
+	//masks of the last pass are the settled board
+	result.bitBoard = bitBoard;
+	result.hash = hash;
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
+		{
+			result.board.set(j, i, cells[i][j]);
+		}
+	}
+	return true;
+}
+
+INSTANTIATE_BOARD_GEOMETRIES(class BasicCascadeResolver)
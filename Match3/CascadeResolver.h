@@ -0,0 +1,45 @@
+#ifndef _CASCADE_RESOLVER_H_
+#define _CASCADE_RESOLVER_H_
+
+//settles a swap in one call, without animations: kill all runs, let blocks
+//fall, spawn new ones on top and repeat until nothing is killed; every step
+//behaves as if all blocks finished their animations before the next one, and
+//new block types are drawn from rng in the same order Board::simulateFalling
+//draws them
+template<int Rows, int Columns, int Types>
+class BasicCascadeResolver
+{
+public:
+	typedef PackedTypeGrid<Rows, Columns, Types>	TypeGrid;
+	typedef BasicBitBoard<Rows, Columns, Types>		BitBoardT;
+	typedef BasicZobrist<Rows, Columns, Types>		ZobristT;
+	typedef typename BitBoardT::Mask				Mask;
+
+	//deeper steps still count in depth and score, but their kill sets are dropped
+	static const int MAX_RECORDED_STEPS = 32;
+
+	struct Result
+	{
+		//settled board, also as bitboard for move generation
+		TypeGrid				board;
+		BitBoardT				bitBoard;
+		//Zobrist hash of board, updated from the hash passed in cell by cell
+		uint64_t				hash;
+		int						score;
+		//number of kill steps
+		int						depth;
+		//blocks killed over all steps
+		int						kills;
+		//blocks killed by every step, before blocks fall
+		Mask					steps[MAX_RECORDED_STEPS];
+	};
+
+	//hash is the Zobrist hash of board; return false for swaps that don't
+	//kill, result.board and result.hash are then the original ones and rng
+	//is left untouched
+	static bool resolve(const TypeGrid &board, uint64_t hash, const Move &swap, BoardRng &rng, Result &result);
+};
+
+typedef BasicCascadeResolver<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> CascadeResolver;
+
+#endif
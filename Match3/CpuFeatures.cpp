@@ -0,0 +1,74 @@
+#include "CpuFeatures.h"
+
+#if defined(MATCH3_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(MATCH3_X86) && defined(_MSC_VER)
+
+static bool detectSSE2()
+{
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+}
+
+static bool detectAVX2()
+{
+	int info[4];
+	__cpuid(info, 0);
+	if(info[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(info, 1);
+	//OS has to save ymm registers on context switch
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	if(!osxsave || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+}
+
+#elif defined(MATCH3_X86)
+
+static bool detectSSE2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse2") != 0;
+}
+
+static bool detectAVX2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+}
+
+#else
+
+static bool detectSSE2()
+{
+	return false;
+}
+
+static bool detectAVX2()
+{
+	return false;
+}
+
+#endif
+
+bool cpuHasSSE2()
+{
+	static const bool hasSSE2 = detectSSE2();
+	return hasSSE2;
+}
+
+bool cpuHasAVX2()
+{
+	static const bool hasAVX2 = detectAVX2();
+	return hasAVX2;
+}
@@ -0,0 +1,22 @@
+#ifndef _CPU_FEATURES_H_
+#define _CPU_FEATURES_H_
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MATCH3_X86 1
+#endif
+
+//functions using SSE2/AVX2 intrinsics have to be marked for gcc/clang,
+//msvc allows them anywhere
+#if defined(MATCH3_X86) && !defined(_MSC_VER)
+#define MATCH3_TARGET_SSE2 __attribute__((target("sse2")))
+#define MATCH3_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MATCH3_TARGET_SSE2
+#define MATCH3_TARGET_AVX2
+#endif
+
+//runtime detection, results are computed once and cached
+bool cpuHasSSE2();
+bool cpuHasAVX2();
+
+#endif
@@ -0,0 +1,124 @@
+#include "DrawCommandBuffer.h"
+#include <algorithm>
+
+//sort key fields from the most significant bits down
+static const int KEY_ORDER_BITS = 28;
+static const int KEY_BLEND_SHIFT = KEY_ORDER_BITS;
+static const int KEY_TEXTURE_SHIFT = KEY_BLEND_SHIFT + 2;
+static const int KEY_CLIP_SHIFT = KEY_TEXTURE_SHIFT + 16;
+static const int KEY_LAYER_SHIFT = KEY_CLIP_SHIFT + 10;
+static const uint64_t KEY_ORDER_MASK = (uint64_t(1) << KEY_ORDER_BITS) - 1;
+static const int MAX_CLIP_RECTS = 1 << 10;
+
+DrawCommandBuffer::DrawCommandBuffer()
+{
+	reset();
+}
+
+void DrawCommandBuffer::reset()
+{
+	commands.clear();
+	clipRects.clear();
+	DrawClipRect none = { false, 0, 0, 0, 0 };
+	clipRects.push_back(none);
+	layer = 0;
+	clip = 0;
+	blend = DrawBlend::None;
+	color[0] = color[1] = color[2] = color[3] = 255;
+}
+
+void DrawCommandBuffer::clear()
+{
+	commands.clear();
+}
+
+void DrawCommandBuffer::beginLayer()
+{
+	//everything past the last layer is drawn in it, in submission order
+	layer = std::min(layer + 1, MAX_LAYERS - 1);
+}
+
+void DrawCommandBuffer::setColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	color[0] = r;
+	color[1] = g;
+	color[2] = b;
+	color[3] = a;
+	blend = DrawBlend::Alpha;
+}
+
+void DrawCommandBuffer::setClipRect(int x, int y, int w, int h)
+{
+	const DrawClipRect &current = clipRects[clip];
+	if(current.enabled && current.x == x && current.y == y && current.w == w && current.h == h)
+	{
+		return;
+	}
+	if((int)clipRects.size() == MAX_CLIP_RECTS)
+	{
+		//out of key bits, further clip rects are dropped
+		return;
+	}
+	DrawClipRect rect = { true, x, y, w, h };
+	clip = (int)clipRects.size();
+	clipRects.push_back(rect);
+}
+
+void DrawCommandBuffer::resetClipRect()
+{
+	clip = 0;
+}
+
+void DrawCommandBuffer::add(int texture, DrawBlend drawBlend, int x, int y, int w, int h)
+{
+	DrawCommand c;
+	const uint64_t order = commands.size() & KEY_ORDER_MASK;
+	c.key = ((uint64_t)layer << KEY_LAYER_SHIFT) | ((uint64_t)clip << KEY_CLIP_SHIFT)
+		| ((uint64_t)(uint16_t)(texture + 1) << KEY_TEXTURE_SHIFT) | ((uint64_t)drawBlend << KEY_BLEND_SHIFT) | order;
+	c.x = (int16_t)x;
+	c.y = (int16_t)y;
+	c.w = (int16_t)w;
+	c.h = (int16_t)h;
+	c.texture = (int16_t)texture;
+	c.sprite = 0;
+	c.blend = drawBlend;
+	c.r = color[0];
+	c.g = color[1];
+	c.b = color[2];
+	c.a = color[3];
+	c.layer = (uint8_t)layer;
+	c.clip = (uint16_t)clip;
+	commands.push_back(c);
+}
+
+void DrawCommandBuffer::drawTexture(int texture, int sprite, int x, int y, int w, int h, uint8_t alpha)
+{
+	add(texture, DrawBlend::Texture, x, y, w, h);
+	DrawCommand &c = commands.back();
+	c.sprite = (int16_t)sprite;
+	c.r = c.g = c.b = 255;
+	c.a = alpha;
+}
+
+void DrawCommandBuffer::drawFilledRectangle(int x, int y, int w, int h)
+{
+	add(NO_TEXTURE, blend, x, y, w, h);
+}
+
+void DrawCommandBuffer::sort()
+{
+	std::sort(commands.begin(), commands.end(), [] (const DrawCommand &a, const DrawCommand &b) -> bool {
+		return a.key < b.key;
+	});
+}
+
+std::size_t DrawCommandBuffer::getBatchSize(std::size_t first) const
+{
+	const uint64_t batchKey = commands[first].key & ~KEY_ORDER_MASK;
+	std::size_t last = first + 1;
+	while(last < commands.size() && (commands[last].key & ~KEY_ORDER_MASK) == batchKey)
+	{
+		++last;
+	}
+	return last - first;
+}
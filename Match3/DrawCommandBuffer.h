@@ -0,0 +1,109 @@
+#ifndef _DRAW_COMMAND_BUFFER_H_
+#define _DRAW_COMMAND_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+const int NO_TEXTURE = -1;
+
+enum class DrawBlend : uint8_t
+{
+	//blend mode of the texture itself
+	Texture,
+	None,
+	Alpha,
+};
+
+//one sprite or filled rectangle, plain data so a whole frame is a flat
+//array that can be sorted and copied around without touching the heap
+struct DrawCommand
+{
+	//layer, clip rect, texture, blend mode and submission order, see sort()
+	uint64_t				key;
+	int16_t					x;
+	int16_t					y;
+	int16_t					w;
+	int16_t					h;
+	//renderer texture or NO_TEXTURE for filled rectangles, and image
+	//inside it; commands are batched by texture only, so sprites packed
+	//into one texture are drawn together
+	int16_t					texture;
+	int16_t					sprite;
+	DrawBlend				blend;
+	uint8_t					r;
+	uint8_t					g;
+	uint8_t					b;
+	uint8_t					a;
+	uint8_t					layer;
+	uint16_t				clip;
+};
+
+struct DrawClipRect
+{
+	bool					enabled;
+	int						x;
+	int						y;
+	int						w;
+	int						h;
+};
+
+//collects draws of a frame with the state they were issued in; draws of one
+//layer are assumed not to overlap, so sort() may group them by texture and
+//blend mode while layers stay in the order they were begun
+class DrawCommandBuffer
+{
+	std::vector<DrawCommand>	commands;
+	//clip rects used this frame, index 0 means no clipping
+	std::vector<DrawClipRect>	clipRects;
+	int						layer;
+	int						clip;
+	DrawBlend				blend;
+	uint8_t					color[4];
+
+	void add(int texture, DrawBlend drawBlend, int x, int y, int w, int h);
+public:
+	static const int MAX_LAYERS = 256;
+
+	DrawCommandBuffer();
+
+	//drops all commands and state, capacity is kept for the next frame
+	void reset();
+	//drops commands already submitted, state stays as it was
+	void clear();
+	void beginLayer();
+	//color and blend mode of following filled rectangles
+	void setColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+	void setClipRect(int x, int y, int w, int h);
+	void resetClipRect();
+	//alpha modulates the texture
+	void drawTexture(int texture, int sprite, int x, int y, int w, int h, uint8_t alpha = 255);
+	void drawFilledRectangle(int x, int y, int w, int h);
+
+	//layers in order, inside a layer by clip rect, texture and blend
+	//mode, and by submission order when all of them are equal
+	void sort();
+
+	std::size_t size() const
+	{
+		return commands.size();
+	}
+	const DrawCommand &operator[](std::size_t index) const
+	{
+		return commands[index];
+	}
+	const DrawClipRect &getClipRect(int index) const
+	{
+		return clipRects[index];
+	}
+	//clip rect following draws get
+	const DrawClipRect &getCurrentClipRect() const
+	{
+		return clipRects[clip];
+	}
+	//length of the run of commands starting at first that can be
+	//submitted together: same layer, clip rect, texture and blend mode
+	std::size_t getBatchSize(std::size_t first) const;
+};
+
+#endif
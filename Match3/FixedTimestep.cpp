@@ -0,0 +1,65 @@
+#include "FixedTimestep.h"
+#include <cstdint>
+
+const unsigned int TICK_UNITS = 1000;
+
+FixedTimestep::FixedTimestep(unsigned int clockTime) :
+startTime(clockTime),
+lastClockTime(clockTime),
+tickCount(0),
+accumulator(0)
+{
+}
+
+unsigned int FixedTimestep::getTickTime(unsigned int tick) const
+{
+	return startTime + (unsigned int)((uint64_t)tick * 1000 / TICK_RATE);
+}
+
+void FixedTimestep::addTime(unsigned int clockTime)
+{
+	//clamped before scaling, so long stalls can't overflow the accumulator
+	const unsigned int elapsed = clockTime - lastClockTime;
+	accumulator += (elapsed < 1000 ? elapsed : 1000) * TICK_RATE;
+	lastClockTime = clockTime;
+	if(accumulator > MAX_CATCH_UP_TICKS * TICK_UNITS)
+	{
+		accumulator = MAX_CATCH_UP_TICKS * TICK_UNITS;
+	}
+}
+
+bool FixedTimestep::tick()
+{
+	if(accumulator < TICK_UNITS)
+	{
+		return false;
+	}
+	accumulator -= TICK_UNITS;
+	tickCount++;
+	return true;
+}
+
+unsigned int FixedTimestep::getTime() const
+{
+	return getTickTime(tickCount);
+}
+
+unsigned int FixedTimestep::getPreviousTime() const
+{
+	return tickCount ? getTickTime(tickCount - 1) : startTime;
+}
+
+unsigned int FixedTimestep::getTimeToNextTick() const
+{
+	if(accumulator >= TICK_UNITS)
+	{
+		return 1;
+	}
+	return (TICK_UNITS - accumulator + TICK_RATE - 1) / TICK_RATE;
+}
+
+unsigned int FixedTimestep::getRenderTime() const
+{
+	const unsigned int previous = getPreviousTime();
+	return previous + (getTime() - previous) * accumulator / TICK_UNITS;
+}
@@ -0,0 +1,40 @@
+#ifndef _FIXED_TIMESTEP_H_
+#define _FIXED_TIMESTEP_H_
+
+//logical ticks per second, game logic runs at this rate whatever the display does
+const int TICK_RATE = 120;
+//longest stretch of real time caught up in one frame, anything beyond is dropped
+//so a stalled frame doesn't make the next one simulate seconds of game
+const int MAX_CATCH_UP_TICKS = TICK_RATE / 4;
+
+//turns a variable rate clock into fixed rate ticks: real time is accumulated
+//and consumed one tick at a time, tick n happens at startTime + n * 1000 / TICK_RATE
+//milliseconds, so tick times don't depend on when frames are drawn
+class FixedTimestep
+{
+	unsigned int		startTime;
+	unsigned int		lastClockTime;
+	unsigned int		tickCount;
+	//real time not simulated yet, 1000 units per tick (TICK_RATE units per millisecond)
+	unsigned int		accumulator;
+
+	unsigned int getTickTime(unsigned int tick) const;
+public:
+	FixedTimestep(unsigned int clockTime);
+
+	//account real time elapsed up to clockTime
+	void addTime(unsigned int clockTime);
+	//consume one tick of accumulated time, false if less than a tick is left
+	bool tick();
+
+	//time of last tick, game logic and input happen at it
+	unsigned int getTime() const;
+	unsigned int getPreviousTime() const;
+	//milliseconds of real time until next tick is due, at least 1
+	unsigned int getTimeToNextTick() const;
+	//time between previous and last tick matching the leftover accumulated time,
+	//rendering at it interpolates between the two logical states
+	unsigned int getRenderTime() const;
+};
+
+#endif
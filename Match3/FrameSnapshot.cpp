@@ -0,0 +1,154 @@
+#include "FrameSnapshot.h"
+#include "Platform.h"
+#include <cstring>
+
+void FrameSnapshot::clear()
+{
+	commands.clear();
+	text.clear();
+}
+
+SnapshotCommand &FrameSnapshot::add(SnapshotOp op)
+{
+	SnapshotCommand c;
+	c.op = op;
+	c.texture = 0;
+	c.r = c.g = c.b = c.a = 0;
+	c.x = c.y = c.w = c.h = 0;
+	c.scale = 1.0f;
+	c.text = 0;
+	commands.push_back(c);
+	return commands.back();
+}
+
+void FrameSnapshot::addText(const char *s, int x, int y)
+{
+	SnapshotCommand &c = add(SnapshotOp::DrawText);
+	c.x = (int16_t)x;
+	c.y = (int16_t)y;
+	c.text = (uint32_t)text.size();
+	text.insert(text.end(), s, s + strlen(s) + 1);
+}
+
+void FrameSnapshot::replay(Renderer &renderer) const
+{
+	for(const SnapshotCommand &c : commands)
+	{
+		switch(c.op)
+		{
+			case SnapshotOp::BeginLayer:
+				renderer.beginLayer();
+				break;
+			case SnapshotOp::SetColor:
+				renderer.setColor(c.r, c.g, c.b, c.a);
+				break;
+			case SnapshotOp::SetClipRect:
+				renderer.setClipRect(c.x, c.y, c.w, c.h);
+				break;
+			case SnapshotOp::ResetClipRect:
+				renderer.resetClipRect();
+				break;
+			case SnapshotOp::DrawBackground:
+				renderer.drawBackground((TextureID)c.texture);
+				break;
+			case SnapshotOp::DrawTexture:
+				renderer.drawTexture((TextureID)c.texture, c.x, c.y);
+				break;
+			case SnapshotOp::DrawTextureCentered:
+				renderer.drawTextureCentered((TextureID)c.texture, c.x, c.y, c.w, c.h, c.scale);
+				break;
+			case SnapshotOp::DrawFilledRectangle:
+				renderer.drawFilledRectangle(c.x, c.y, c.w, c.h);
+				break;
+			case SnapshotOp::DrawText:
+				renderer.drawText(&text[c.text], c.x, c.y);
+				break;
+		}
+	}
+}
+
+SnapshotRenderer::SnapshotRenderer(TripleBuffer<FrameSnapshot> &f, EventSource &c) :
+frames(f),
+consumer(c),
+frame(&f.getWriteBuffer())
+{
+}
+
+void SnapshotRenderer::clear()
+{
+	frame = &frames.getWriteBuffer();
+	frame->clear();
+}
+
+void SnapshotRenderer::beginLayer()
+{
+	frame->add(SnapshotOp::BeginLayer);
+}
+
+void SnapshotRenderer::setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+	SnapshotCommand &c = frame->add(SnapshotOp::SetColor);
+	c.r = r;
+	c.g = g;
+	c.b = b;
+	c.a = a;
+}
+
+void SnapshotRenderer::setClipRect(int x, int y, int w, int h)
+{
+	SnapshotCommand &c = frame->add(SnapshotOp::SetClipRect);
+	c.x = (int16_t)x;
+	c.y = (int16_t)y;
+	c.w = (int16_t)w;
+	c.h = (int16_t)h;
+}
+
+void SnapshotRenderer::resetClipRect()
+{
+	frame->add(SnapshotOp::ResetClipRect);
+}
+
+void SnapshotRenderer::drawBackground(TextureID tid)
+{
+	frame->add(SnapshotOp::DrawBackground).texture = (uint8_t)tid;
+}
+
+void SnapshotRenderer::drawTexture(TextureID tid, int x, int y)
+{
+	SnapshotCommand &c = frame->add(SnapshotOp::DrawTexture);
+	c.texture = (uint8_t)tid;
+	c.x = (int16_t)x;
+	c.y = (int16_t)y;
+}
+
+void SnapshotRenderer::drawTextureCentered(TextureID tid, int x, int y, int w, int h, double scale)
+{
+	SnapshotCommand &c = frame->add(SnapshotOp::DrawTextureCentered);
+	c.texture = (uint8_t)tid;
+	c.x = (int16_t)x;
+	c.y = (int16_t)y;
+	c.w = (int16_t)w;
+	c.h = (int16_t)h;
+	c.scale = (float)scale;
+}
+
+void SnapshotRenderer::drawFilledRectangle(int x, int y, int w, int h)
+{
+	SnapshotCommand &c = frame->add(SnapshotOp::DrawFilledRectangle);
+	c.x = (int16_t)x;
+	c.y = (int16_t)y;
+	c.w = (int16_t)w;
+	c.h = (int16_t)h;
+}
+
+void SnapshotRenderer::drawText(const char *text, int x, int y)
+{
+	frame->addText(text, x, y);
+}
+
+void SnapshotRenderer::present()
+{
+	frames.publish();
+	frame = &frames.getWriteBuffer();
+	consumer.wake();
+}
@@ -0,0 +1,83 @@
+#ifndef _FRAME_SNAPSHOT_H_
+#define _FRAME_SNAPSHOT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Renderer.h"
+#include "TripleBuffer.h"
+
+class EventSource;
+
+enum class SnapshotOp : uint8_t
+{
+	BeginLayer,
+	SetColor,
+	SetClipRect,
+	ResetClipRect,
+	DrawBackground,
+	DrawTexture,
+	DrawTextureCentered,
+	DrawFilledRectangle,
+	DrawText,
+};
+
+//one Renderer call with its arguments
+struct SnapshotCommand
+{
+	SnapshotOp				op;
+	uint8_t					texture;
+	uint8_t					r;
+	uint8_t					g;
+	uint8_t					b;
+	uint8_t					a;
+	int16_t					x;
+	int16_t					y;
+	int16_t					w;
+	int16_t					h;
+	float					scale;
+	//offset of DrawText string in FrameSnapshot::text
+	uint32_t				text;
+};
+
+//draw calls of one frame kept for replaying on another thread, block
+//positions, scales and marker alphas are already resolved, so replaying
+//needs nothing else; capacity is kept between frames
+class FrameSnapshot
+{
+	std::vector<SnapshotCommand>	commands;
+	//zero terminated strings of DrawText commands
+	std::vector<char>				text;
+public:
+	void clear();
+	SnapshotCommand &add(SnapshotOp op);
+	void addText(const char *s, int x, int y);
+	//issue recorded calls, clear() and present() are left to the caller
+	void replay(Renderer &renderer) const;
+};
+
+//renderer recording frames into snapshots instead of drawing them: clear()
+//starts a frame in write buffer of frames, present() publishes it and
+//wakes the thread drawing them through consumer
+class SnapshotRenderer : public Renderer
+{
+	TripleBuffer<FrameSnapshot>	&frames;
+	EventSource				&consumer;
+	FrameSnapshot			*frame;
+public:
+	SnapshotRenderer(TripleBuffer<FrameSnapshot> &f, EventSource &c);
+
+	void clear();
+	void beginLayer();
+	void setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+	void setClipRect(int x, int y, int w, int h);
+	void resetClipRect();
+	void drawBackground(TextureID tid);
+	void drawTexture(TextureID tid, int x, int y);
+	void drawTextureCentered(TextureID tid, int x, int y, int w, int h, double scale = 1.0);
+	void drawFilledRectangle(int x, int y, int w, int h);
+	void drawText(const char *text, int x, int y);
+	void present();
+};
+
+#endif
@@ -1,17 +1,48 @@
 #include "GameImpl.h"
-#include "SDL.h"
-#include <sstream>
+#include "FrameSnapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <thread>
 
-Game::impl::impl(Renderer &r) :
+CachedText::CachedText(const char *l) :
+label(l),
+value(0),
+valid(false)
+{
+	text[0] = 0;
+}
+
+const char *CachedText::format(int v)
+{
+	if(!valid || v != value)
+	{
+		snprintf(text, sizeof(text), "%s %d", label, v);
+		value = v;
+		valid = true;
+	}
+	return text;
+}
+
+Game::impl::impl(Renderer &r, unsigned int s) :
 renderer(r),
+seed(s),
 board(new Board(r)),
 gameStarted(false),
 gameStartTime(0),
 gameStopTime(0),
 timeLeftSeconds(TIME_LIMIT),
 score(0),
-firstGame(true)
+firstGame(true),
+timeText("Time:"),
+scoreText("Score:"),
+cascadeDepth(0),
+profilerOverlay(false),
+redrawRequested(true)
 {
+	stats.clear();
+	renderedFrame = summarizeFrame();
+	board->rng.seed(seed);
 }
 
 Game::impl::~impl()
@@ -20,65 +51,272 @@ Game::impl::~impl()
 
 void Game::impl::render(const unsigned int currentTime)
 {
-	renderer.clear();
-	renderer.drawBackground(TID_BACKGROUND);
+	{
+		PROFILE_SCOPE("render");
+		renderer.clear();
+		renderer.drawBackground(TID_BACKGROUND);
 
-	renderer.setClipRect(BOARD_POS_X, BOARD_POS_Y, NUM_BLOCK_COLUMNS * BLOCK_SIZE_X, NUM_BLOCK_ROWS * BLOCK_SIZE_Y);
+		renderer.beginLayer();
+		renderBoard(currentTime);
+		renderer.beginLayer();
+		renderText();
+		if(profilerOverlay)
+		{
+			renderProfilerOverlay();
+		}
+	}
 
-	board->applyToAllBlocks([&] (BlockPtr b) {
-		b->simulate(currentTime);
-		b->render(currentTime);
-	});
+	PROFILE_SCOPE("present");
+	renderer.present();
 
+	renderedFrame = summarizeFrame();
+	redrawRequested = false;
+}
 
-	board->applyToAllBlocks([&] (BlockPtr b) {
-		b->renderOverlay(currentTime);
-	});
+bool Game::impl::isAnimating() const
+{
+	//board waits for the first click without being simulated
+	if(firstGame && !gameStarted)
+	{
+		return false;
+	}
+	return !board->isStill();
+}
 
-	renderer.resetClipRect();
+FrameSummary Game::impl::summarizeFrame() const
+{
+	FrameSummary frame;
+	frame.boardVersion = board->version;
+	frame.timeLeftSeconds = timeLeftSeconds;
+	frame.score = score;
+	frame.gameStarted = gameStarted;
+	frame.animating = isAnimating();
+	return frame;
+}
 
-	std::ostringstream timeStream;
-	timeStream << "Time: "  << timeLeftSeconds;
-	renderer.drawText(timeStream.str().c_str(), 25, 125);
+bool Game::impl::needsRender() const
+{
+	if(redrawRequested || profilerOverlay)
+	{
+		return true;
+	}
+	//last frame of an animation has to be drawn too
+	const FrameSummary frame = summarizeFrame();
+	return frame.animating || renderedFrame.animating ||
+		frame.boardVersion != renderedFrame.boardVersion ||
+		frame.timeLeftSeconds != renderedFrame.timeLeftSeconds ||
+		frame.score != renderedFrame.score ||
+		frame.gameStarted != renderedFrame.gameStarted;
+}
 
-	std::ostringstream scoreStream;
-	scoreStream << "Score: "  << score;
-	renderer.drawText(scoreStream.str().c_str(), 25, 175);
+unsigned int Game::impl::getIdleTimeout(const unsigned int currentTime, const bool visible) const
+{
+	if(!visible)
+	{
+		return HIDDEN_WAIT;
+	}
+	if(needsRender())
+	{
+		return 0;
+	}
+	unsigned int timeout = MAX_IDLE_WAIT;
+	if(gameStarted)
+	{
+		//until HUD timer shows next second
+		const unsigned int nextSecond = gameStartTime + (TIME_LIMIT - timeLeftSeconds + 1) * 1000;
+		timeout = std::min(timeout, nextSecond > currentTime ? nextSecond - currentTime : 0);
+	}
+	return timeout;
+}
 
-	renderer.present();
+void Game::impl::renderBoard(const unsigned int currentTime)
+{
+	PROFILE_SCOPE("blocks");
+	renderer.setClipRect(BOARD_POS_X, BOARD_POS_Y, NUM_BLOCK_COLUMNS * BLOCK_SIZE_X, NUM_BLOCK_ROWS * BLOCK_SIZE_Y);
+
+	board->store.renderAll(currentTime);
+
+	//blocks moving on top of others
+	renderer.beginLayer();
+	board->store.renderAllOverlays(currentTime);
+
+	renderer.resetClipRect();
+}
+
+void Game::impl::renderText()
+{
+	PROFILE_SCOPE("text");
+	renderer.drawText(timeText.format(timeLeftSeconds), 25, 125);
+	renderer.drawText(scoreText.format(score), 25, 175);
 }
 
-void Game::impl::runEventLoop()
+void Game::impl::renderProfilerOverlay()
 {
+	PROFILE_SCOPE("overlay");
+	//previous frame with its top level phases, in milliseconds
+	if(!Profiler::getLastScope("frame", profileEvents))
+	{
+		return;
+	}
+	const int frameDepth = profileEvents[0].depth;
+	int y = 250;
+	for(const ProfileEvent &e : profileEvents)
+	{
+		if(e.depth > frameDepth + 1)
+		{
+			continue;
+		}
+		char line[64];
+		snprintf(line, sizeof(line), "%s %.2f", e.name, e.duration / 1e6);
+		renderer.drawText(line, 25, y);
+		y += 40;
+	}
+}
+
+void Game::impl::runEventLoop(Clock &clock, EventSource &events, SessionRecorder *recorder)
+{
+	if(recorder)
+	{
+		recorder->begin(seed);
+	}
 	board->generate();
 
 	bool quit = false;
+	FixedTimestep timestep(clock.getTicks());
 
 	while(!quit)
 	{
-		unsigned int currentTime = SDL_GetTicks();
+		bool visible;
+		{
+			PROFILE_SCOPE("frame");
+			timestep.addTime(clock.getTicks());
 
-		if(pollEvents(currentTime))
+			//as many ticks as real time since last frame covers, so game
+			//logic doesn't depend on display refresh rate
+			while(timestep.tick())
+			{
+				const unsigned int tickTime = timestep.getTime();
+				if(recorder)
+				{
+					recorder->frame(tickTime);
+				}
+				simulate(tickTime);
+			}
+
+			//input lands on the tick grid too, at time of last tick; ticks
+			//go first so input after an idle wait isn't applied in the past
+			if(pollEvents(timestep.getTime(), events, recorder))
+			{
+				quit = true;
+			}
+
+			visible = events.isVisible();
+			if(events.checkExposed())
+			{
+				redrawRequested = true;
+			}
+			if(visible && needsRender())
+			{
+				render(timestep.getRenderTime());
+			}
+		}
+
+		//nothing changes on screen until input or next HUD second arrives,
+		//so sleep instead of drawing the same frame again; frames that keep
+		//changing are drawn once per tick, presenting doesn't pace this loop
+		unsigned int timeout = getIdleTimeout(timestep.getTime(), visible);
+		if(0 == timeout)
+		{
+			timeout = timestep.getTimeToNextTick();
+		}
+		if(!quit)
 		{
-			quit = true;
+			events.waitEvent(timeout);
 		}
+	}
+}
 
-		simulate(currentTime);
+//what the thread calling runEventLoop() shares with the game logic thread
+struct Game::frontend
+{
+	TripleBuffer<FrameSnapshot>	frames;
+	//game logic renders into frames
+	SnapshotRenderer		snapshotRenderer;
+	QueuedEventSource		input;
+	std::atomic<bool>		finished;
 
-		render(currentTime);
-	}
+	frontend(EventSource &events);
+};
+
+Game::frontend::frontend(EventSource &events) :
+snapshotRenderer(frames, events),
+finished(false)
+{
 }
 
-Game::Game(Renderer &r)
+Game::Game(Renderer &r, Clock &c, EventSource &e) :
+renderer(r),
+clock(c),
+events(e),
+recorder(nullptr)
 {
-	pimpl = std::unique_ptr<impl>(new impl(r));
+	pfrontend = std::unique_ptr<frontend>(new frontend(e));
+	pimpl = std::unique_ptr<impl>(new impl(pfrontend->snapshotRenderer, (unsigned int)std::time(0)));
 }
 
 Game::~Game()
 {
 }
 
+void Game::setProfilerOverlay(bool show)
+{
+	pimpl->profilerOverlay = show;
+}
+
+void Game::setRecorder(SessionRecorder *r)
+{
+	recorder = r;
+}
+
 void Game::runEventLoop()
 {
-	pimpl->runEventLoop();
+	frontend &f = *pfrontend;
+	std::thread logic([this, &f] {
+		pimpl->runEventLoop(clock, f.input, recorder);
+		f.finished = true;
+		events.wake();
+	});
+
+	//this thread only moves input over and draws latest snapshot, so slow
+	//presenting never holds game logic back and a slow tick never keeps
+	//the last frame from being drawn again
+	while(!f.finished)
+	{
+		InputEvent e;
+		while(events.pollEvent(e))
+		{
+			f.input.push(e);
+		}
+		f.input.setVisible(events.isVisible());
+
+		const bool exposed = events.checkExposed();
+		if(f.frames.consume() || exposed)
+		{
+			PROFILE_SCOPE("draw");
+			renderer.clear();
+			f.frames.getReadBuffer().replay(renderer);
+			renderer.present();
+		}
+		else
+		{
+			//woken by input or by a published frame
+			events.waitEvent(MAX_IDLE_WAIT);
+		}
+	}
+	logic.join();
+
+	if(recorder)
+	{
+		recorder->end();
+	}
 }
@@ -2,20 +2,66 @@
 #ifndef _GAME_H_
 #define _GAME_H_
 
-#include "Block.h"
-
 const int NUM_BLOCK_TYPES = 5;
 const int NUM_BLOCK_COLUMNS = 8;
 const int NUM_BLOCK_ROWS = 8;
 
+//board classes are templates on (rows, columns, block types) defined in .cpp files,
+//every geometry we run is explicitly instantiated there through this list
+#define INSTANTIATE_BOARD_GEOMETRIES(CLASS) \
+	template CLASS<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES>; \
+	template CLASS<9, 9, 5>; \
+	template CLASS<10, 12, 5>;
+
+#include "BlockStore.h"
+#include "Platform.h"
+
+//longer cascades are counted as the longest one
+const int MAX_CASCADE_DEPTH = 16;
+
+//per game counters, reset whenever a new game starts
+struct GameStats
+{
+	int						swaps;
+	//blocks killed
+	int						kills;
+	//kill passes that killed something
+	int						killPasses;
+	//number of cascades of every depth (kill passes until board settled)
+	int						cascades[MAX_CASCADE_DEPTH + 1];
+	//boards regenerated because no move was left
+	int						reshuffles;
+
+	void clear();
+};
+
+class SessionRecorder;
+
+//game logic runs on a thread of its own, rendering into snapshots that
+//the thread calling runEventLoop() draws on renderer
 class Game
 {
+	//snapshot renderer pimpl draws into lives here, so it goes after pimpl
+	struct					frontend;
+	std::unique_ptr<frontend>	pfrontend;
 	struct					impl;
 	std::unique_ptr<impl>	pimpl;
+	Renderer				&renderer;
+	Clock					&clock;
+	EventSource				&events;
+	SessionRecorder			*recorder;
+
+	//headless sessions run the same game logic
+	friend class GameSession;
 public:
-	Game(Renderer &r);
+	Game(Renderer &r, Clock &c, EventSource &e);
 	~Game();
 
+	//seed and every input of the session are written to recorder,
+	//must be set before runEventLoop()
+	void setRecorder(SessionRecorder *r);
+	//draw phase timings of last frame, see Profiler
+	void setProfilerOverlay(bool show);
 	void runEventLoop();
 };
 
@@ -5,16 +5,59 @@
 #include <functional>
 
 #include "Game.h"
+#include "Profiler.h"
+#include "FixedTimestep.h"
+#include "BitBoard.h"
+#include "TypeGrid.h"
+#include "BoardState.h"
+#include "Zobrist.h"
+#include "TranspositionTable.h"
 #include "Board.h"
 #include "KillCalculator.h"
+#include "KillTable.h"
+#include "MoveGenerator.h"
+#include "BoardGenerator.h"
+#include "CascadeResolver.h"
+#include "Bot.h"
+#include "SessionRecord.h"
 
 const int TIME_LIMIT = 60;
 const int POST_GAME_TIME = 1;
+//longest sleep of an idle event loop, game time must not fall behind
+//more than FixedTimestep catches up in one frame
+const unsigned int MAX_IDLE_WAIT = 200;
+//loop period while window is hidden, game logic goes on but nothing is drawn
+const unsigned int HIDDEN_WAIT = 200;
+
+//"label value" text formatted again only when value changes
+struct CachedText
+{
+	const char				*label;
+	int						value;
+	bool					valid;
+	char					text[32];
+
+	CachedText(const char *l);
+	const char *format(int v);
+};
+
+//everything a rendered frame shows besides animations, a frame is drawn
+//again only if it changed or something was animating
+struct FrameSummary
+{
+	unsigned int			boardVersion;
+	int						timeLeftSeconds;
+	int						score;
+	bool					gameStarted;
+	bool					animating;
+};
 
 struct Game::impl
 {
 	Renderer				&renderer;
 
+	//board rng seed, the whole session follows from it and the input
+	unsigned int			seed;
 	BoardPtr				board;
 
 	bool					gameStarted;
@@ -23,8 +66,20 @@ struct Game::impl
 	int						timeLeftSeconds;
 	int						score;
 	bool					firstGame;
+	CachedText				timeText;
+	CachedText				scoreText;
 
-	impl(Renderer &r);
+	GameStats				stats;
+	//kill passes since board was last settled
+	int						cascadeDepth;
+	//phase timings of last frame drawn over the game
+	bool					profilerOverlay;
+	std::vector<ProfileEvent>	profileEvents;
+	//state shown by last rendered frame, input and exposed window force a new one
+	FrameSummary			renderedFrame;
+	bool					redrawRequested;
+
+	impl(Renderer &r, unsigned int s);
 	~impl();
 
 //game logic
@@ -33,10 +88,19 @@ struct Game::impl
 
 //rendering
 	void render(unsigned int currentTime);
+	void renderBoard(unsigned int currentTime);
+	void renderText();
+	void renderProfilerOverlay();
+	bool isAnimating() const;
+	FrameSummary summarizeFrame() const;
+	//false if drawing now would repeat last frame
+	bool needsRender() const;
+	//how long the loop may sleep waiting for input, 0 if next frame is due right away
+	unsigned int getIdleTimeout(unsigned int currentTime, bool visible) const;
 
 //user input processing
-	bool trySwap(unsigned int currentTime, BlockPtr src, BlockPtr dst);
-	BlockPtr getSelectedBlock();
+	bool trySwap(unsigned int currentTime, BlockID src, BlockID dst);
+	BlockID getSelectedBlock();
 
 	void processMouseMotion(unsigned int currentTime, int x, int y);
 	void processMouseDown(unsigned int currentTime, int x, int y);
@@ -45,10 +109,32 @@ struct Game::impl
 	//mouse up outside of mouse down block
 	void processBlockDrag(unsigned int currentTime, int x, int y);
 	void processMouseUp(unsigned int currentTime, int x, int y);
-	bool pollEvents(unsigned int currentTime);
+	//return true if user wants to quit
+	bool applyInput(unsigned int currentTime, const InputEvent &e);
+	bool pollEvents(unsigned int currentTime, EventSource &events, SessionRecorder *recorder);
 
 //main game loop
-	void runEventLoop();
+	void runEventLoop(Clock &clock, EventSource &events, SessionRecorder *recorder);
+};
+
+//logic state of a game with a settled board, enough to continue a session
+//the same way it went on when the checkpoint was taken
+struct GameSessionCheckpoint
+{
+	unsigned int			time;
+	Board::State			board;
+	//cells of selected and mouse down blocks or -1
+	int						selectedX;
+	int						selectedY;
+	int						mouseDownX;
+	int						mouseDownY;
+	bool					gameStarted;
+	unsigned int			gameStartTime;
+	unsigned int			gameStopTime;
+	int						timeLeftSeconds;
+	int						score;
+	bool					firstGame;
+	GameStats				stats;
 };
 
 //for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
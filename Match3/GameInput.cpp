@@ -1,44 +1,42 @@
 #include "GameImpl.h"
-#include "SDL.h"
 
-BlockPtr Game::impl::getSelectedBlock()
+BlockID Game::impl::getSelectedBlock()
 {
-	return board->findBlock([] (BlockPtr b) -> bool {
-		return b->isSelected();
+	const BlockStore &store = board->store;
+	return board->findBlock([&] (BlockID b) -> bool {
+		return store.isSelected(b);
 	});
 }
 
 
-bool Game::impl::trySwap(const unsigned int currentTime, BlockPtr src, BlockPtr dst)
+bool Game::impl::trySwap(const unsigned int currentTime, BlockID src, BlockID dst)
 {
-	if(!src->isNeighbor(dst))
+	const BlockStore &store = board->store;
+	if(!store.isNeighbor(src, dst))
 	{
 		return false;
 	}
-	if(!src->canMove())
+	if(!store.canMove(src))
 	{
 		return false;
 	}
-	if(!dst->canMove())
+	if(!store.canMove(dst))
 	{
 		return false;
 	}
 
-	int srcX = src->getBoardX();
-	int srcY = src->getBoardY();
-	int dstX = dst->getBoardX();
-	int dstY = dst->getBoardY();
+	int srcX = store.getBoardX(src);
+	int srcY = store.getBoardY(src);
+	int dstX = store.getBoardX(dst);
+	int dstY = store.getBoardY(dst);
 
-	KillCalculator killCalculator(*board);
-	killCalculator.swapTypes(srcX, srcY, dstX, dstY);
-	killCalculator.calculateKills();
-	if(!killCalculator.hasKills())
+	if(!board->isKillingSwap(srcX, srcY, dstX, dstY))
 	{
 		return false;
 	}
 
-	std::swap(board->blocks[dstY][dstX], board->blocks[srcY][srcX]);
-	src->swapWith(currentTime, dst);
+	board->swapBlocks(currentTime, srcX, srcY, dstX, dstY);
+	stats.swaps++;
 
 	return true;
 }
@@ -49,14 +47,15 @@ void Game::impl::processMouseMotion(const unsigned int currentTime, int x, int y
 	{
 		return;
 	}
-	board->applyToAllBlocks([&] (BlockPtr b) {
-		if(b->canMove() && b->isInside(x, y))
+	BlockStore &store = board->store;
+	board->applyToAllBlocks([&] (BlockID b) {
+		if(store.canMove(b) && store.isInside(b, x, y))
 		{
-			b->mark(currentTime);
+			store.mark(b, currentTime);
 		}
 		else
 		{
-			b->unmark(currentTime);
+			store.unmark(b, currentTime);
 		}
 	});
 }
@@ -70,17 +69,19 @@ void Game::impl::processMouseDown(const unsigned int currentTime, int x, int y)
 			return;
 		}
 	}
-	board->mouseDownBlock = board->findBlock([=] (BlockPtr b) -> bool {
-		return b->canMove() && b->isInside(x, y);
+	const BlockStore &store = board->store;
+	board->mouseDownBlock = board->findBlock([&] (BlockID b) -> bool {
+		return store.canMove(b) && store.isInside(b, x, y);
 	});
 }
 
 void Game::impl::processBlockClick(const unsigned int currentTime)
 {
-	BlockPtr selectedBlock = getSelectedBlock();
-	if(!selectedBlock)
+	BlockStore &store = board->store;
+	BlockID selectedBlock = getSelectedBlock();
+	if(selectedBlock == NO_BLOCK)
 	{
-		board->mouseDownBlock->select(currentTime);
+		store.select(board->mouseDownBlock, currentTime);
 		return;
 	}
 	if(board->mouseDownBlock == selectedBlock)
@@ -90,24 +91,25 @@ void Game::impl::processBlockClick(const unsigned int currentTime)
 	//"select swap"
 	if(!trySwap(currentTime, selectedBlock, board->mouseDownBlock))
 	{
-		selectedBlock->unselect(currentTime);
-		board->mouseDownBlock->select(currentTime);
+		store.unselect(selectedBlock, currentTime);
+		store.select(board->mouseDownBlock, currentTime);
 	}
 }
 
 void Game::impl::processBlockDrag(const unsigned int currentTime, int x, int y)
 {
 	//"drag swap"
+	const BlockStore &store = board->store;
 	int dx, dy;
-	board->mouseDownBlock->getSwapDirection(x, y, dx, dy);
-	int srcX = board->mouseDownBlock->getBoardX();
-	int srcY = board->mouseDownBlock->getBoardY();
+	store.getSwapDirection(board->mouseDownBlock, x, y, dx, dy);
+	int srcX = store.getBoardX(board->mouseDownBlock);
+	int srcY = store.getBoardY(board->mouseDownBlock);
 	int dstX = srcX + dx;
 	int dstY = srcY + dy;
 	if(dstX >= 0 && dstX < NUM_BLOCK_COLUMNS &&
 		dstY >= 0 && dstY < NUM_BLOCK_ROWS)
 	{
-		if(board->blocks[dstY][dstX])
+		if(board->blocks[dstY][dstX] != NO_BLOCK)
 		{
 			trySwap(currentTime, board->mouseDownBlock, board->blocks[dstY][dstX]);
 		}
@@ -120,45 +122,60 @@ void Game::impl::processMouseUp(const unsigned int currentTime, int x, int y)
 	{
 		return;
 	}
-	if(!board->mouseDownBlock)
+	if(board->mouseDownBlock == NO_BLOCK)
 	{
 		return;
 	}
-	BlockPtr mouseUpBlock = board->findBlock([=] (BlockPtr b) -> bool {
-		return b->canMove() && b->isInside(x, y);
+	const BlockStore &store = board->store;
+	BlockID mouseUpBlock = board->findBlock([&] (BlockID b) -> bool {
+		return store.canMove(b) && store.isInside(b, x, y);
 	});
 
 	if(mouseUpBlock == board->mouseDownBlock)
 	{
 		processBlockClick(currentTime);
 	}
-	else if(board->mouseDownBlock->canMove() && !board->mouseDownBlock->isInside(x, y))
+	else if(store.canMove(board->mouseDownBlock) && !store.isInside(board->mouseDownBlock, x, y))
 	{
 		processBlockDrag(currentTime, x, y);
 	}
-	board->mouseDownBlock = nullptr;
+	board->mouseDownBlock = NO_BLOCK;
 }
 
-bool Game::impl::pollEvents(const unsigned int currentTime)
+bool Game::impl::applyInput(const unsigned int currentTime, const InputEvent &e)
 {
-	SDL_Event e;
-	while(SDL_PollEvent(&e))
+	//even mouse motion may start marker animations
+	redrawRequested = true;
+	switch(e.type)
 	{
-		switch(e.type)
+		case InputEventType::Quit:
+			return true;
+		case InputEventType::MouseDown:
+			processMouseDown(currentTime, e.x, e.y);
+			break;
+		case InputEventType::MouseMotion:
+			processMouseMotion(currentTime, e.x, e.y);
+			break;
+		case InputEventType::MouseUp:
+			processMouseUp(currentTime, e.x, e.y);
+			break;
+	}
+	return false;
+}
+
+bool Game::impl::pollEvents(const unsigned int currentTime, EventSource &events, SessionRecorder *recorder)
+{
+	PROFILE_SCOPE("input");
+	InputEvent e;
+	while(events.pollEvent(e))
+	{
+		if(recorder)
+		{
+			recorder->input(currentTime, e);
+		}
+		if(applyInput(currentTime, e))
 		{
-			case SDL_QUIT:
-			//case SDL_KEYDOWN:
-				return true;
-				break;
-			case SDL_MOUSEBUTTONDOWN:
-				processMouseDown(currentTime, e.motion.x, e.motion.y);
-				break;
-			case SDL_MOUSEMOTION:
-				processMouseMotion(currentTime, e.motion.x, e.motion.y);
-				break;
-			case SDL_MOUSEBUTTONUP:
-				processMouseUp(currentTime, e.motion.x, e.motion.y);
-				break;
+			return true;
 		}
 	}
 	return false;
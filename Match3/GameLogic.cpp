@@ -1,4 +1,17 @@
 #include "GameImpl.h"
+#include <algorithm>
+
+void GameStats::clear()
+{
+	swaps = 0;
+	kills = 0;
+	killPasses = 0;
+	for(int i = 0; i <= MAX_CASCADE_DEPTH; ++i)
+	{
+		cascades[i] = 0;
+	}
+	reshuffles = 0;
+}
 
 bool Game::impl::tryGameStart(unsigned int currentTime)
 {
@@ -15,25 +28,50 @@ bool Game::impl::tryGameStart(unsigned int currentTime)
 	timeLeftSeconds = TIME_LIMIT;
 	score = 0;
 	firstGame = false;
+	stats.clear();
+	cascadeDepth = 0;
 	return true;
 }
 
 void Game::impl::simulate(unsigned int currentTime)
 {
+	PROFILE_SCOPE("simulate");
 	if(firstGame && !gameStarted)
 	{
 		return;
 	}
 
-	int killCount = board->simulateKills(currentTime);
-	if(killCount)
+	//static board can't produce any kills or falls
+	if(board->needsSimulation())
 	{
-		score += 2 + (killCount - 1) * (killCount - 2) / 2;
+		int killCount = board->simulateKills(currentTime);
+		if(killCount)
+		{
+			score += killScore(killCount);
+			stats.kills += killCount;
+			stats.killPasses++;
+			cascadeDepth++;
+		}
+
+		board->removeDeadBlocks();
+
+		board->simulateFalling(currentTime);
+
+		board->markSimulated();
 	}
 
-	board->removeDeadBlocks();
+	if(cascadeDepth && board->isSettled())
+	{
+		stats.cascades[std::min(cascadeDepth, MAX_CASCADE_DEPTH)]++;
+		cascadeDepth = 0;
+	}
 
-	board->simulateFalling(currentTime);
+	//don't let a position without moves stall the game until timeout
+	if(gameStarted && board->isSettled() && !board->hasAnyMove())
+	{
+		board->generate();
+		stats.reshuffles++;
+	}
 
 	if(gameStarted)
 	{
@@ -41,7 +79,7 @@ void Game::impl::simulate(unsigned int currentTime)
 		{
 			gameStopTime = currentTime;
 			gameStarted = false;
-			board->mouseDownBlock = nullptr;
+			board->mouseDownBlock = NO_BLOCK;
 			timeLeftSeconds = 0;
 		}
 		else
@@ -49,4 +87,6 @@ void Game::impl::simulate(unsigned int currentTime)
 			timeLeftSeconds = TIME_LIMIT - (currentTime - gameStartTime) / 1000; 
 		}
 	}
+
+	board->simulateBlocks(currentTime);
 }
@@ -0,0 +1,157 @@
+#include "GameImpl.h"
+#include "GameSession.h"
+
+struct GameSession::impl
+{
+	ManualClock				clock;
+	Game::impl				game;
+
+	impl(Renderer &r, unsigned int seed);
+};
+
+GameSession::impl::impl(Renderer &r, unsigned int seed) :
+game(r, seed)
+{
+	game.board->generate();
+}
+
+GameSession::GameSession(Renderer &r, unsigned int seed)
+{
+	pimpl = std::unique_ptr<impl>(new impl(r, seed));
+}
+
+GameSession::~GameSession()
+{
+}
+
+unsigned int GameSession::getTime() const
+{
+	return pimpl->clock.getTicks();
+}
+
+bool GameSession::start()
+{
+	return pimpl->game.tryGameStart(pimpl->clock.getTicks());
+}
+
+void GameSession::applyInput(const InputEvent &e)
+{
+	pimpl->game.applyInput(pimpl->clock.getTicks(), e);
+}
+
+bool GameSession::trySwap(const Move &move)
+{
+	const Board &board = *pimpl->game.board;
+	BlockID src = board.blocks[move.srcY][move.srcX];
+	BlockID dst = board.blocks[move.dstY][move.dstX];
+	if(src == NO_BLOCK || dst == NO_BLOCK)
+	{
+		return false;
+	}
+	return pimpl->game.trySwap(pimpl->clock.getTicks(), src, dst);
+}
+
+void GameSession::advance(unsigned int dt)
+{
+	pimpl->clock.advance(dt);
+}
+
+void GameSession::simulate()
+{
+	pimpl->game.simulate(pimpl->clock.getTicks());
+}
+
+void GameSession::step(unsigned int dt)
+{
+	advance(dt);
+	simulate();
+}
+
+bool GameSession::saveCheckpoint(GameSessionCheckpoint &checkpoint) const
+{
+	const Game::impl &game = pimpl->game;
+	const Board &board = *game.board;
+	if(!board.isSettled())
+	{
+		return false;
+	}
+	checkpoint.time = pimpl->clock.getTicks();
+	board.saveState(checkpoint.board);
+	checkpoint.selectedX = checkpoint.selectedY = -1;
+	checkpoint.mouseDownX = checkpoint.mouseDownY = -1;
+	BlockID selected = board.findBlock([&] (BlockID b) -> bool {
+		return board.store.isSelected(b);
+	});
+	if(selected != NO_BLOCK)
+	{
+		checkpoint.selectedX = board.store.getBoardX(selected);
+		checkpoint.selectedY = board.store.getBoardY(selected);
+	}
+	if(board.mouseDownBlock != NO_BLOCK)
+	{
+		checkpoint.mouseDownX = board.store.getBoardX(board.mouseDownBlock);
+		checkpoint.mouseDownY = board.store.getBoardY(board.mouseDownBlock);
+	}
+	checkpoint.gameStarted = game.gameStarted;
+	checkpoint.gameStartTime = game.gameStartTime;
+	checkpoint.gameStopTime = game.gameStopTime;
+	checkpoint.timeLeftSeconds = game.timeLeftSeconds;
+	checkpoint.score = game.score;
+	checkpoint.firstGame = game.firstGame;
+	checkpoint.stats = game.stats;
+	return true;
+}
+
+void GameSession::loadCheckpoint(const GameSessionCheckpoint &checkpoint)
+{
+	Game::impl &game = pimpl->game;
+	Board &board = *game.board;
+	pimpl->clock = ManualClock(checkpoint.time);
+	board.loadState(checkpoint.board);
+	if(checkpoint.selectedX != -1)
+	{
+		board.store.select(board.blocks[checkpoint.selectedY][checkpoint.selectedX], checkpoint.time);
+	}
+	if(checkpoint.mouseDownX != -1)
+	{
+		board.mouseDownBlock = board.blocks[checkpoint.mouseDownY][checkpoint.mouseDownX];
+	}
+	game.gameStarted = checkpoint.gameStarted;
+	game.gameStartTime = checkpoint.gameStartTime;
+	game.gameStopTime = checkpoint.gameStopTime;
+	game.timeLeftSeconds = checkpoint.timeLeftSeconds;
+	game.score = checkpoint.score;
+	game.firstGame = checkpoint.firstGame;
+	game.stats = checkpoint.stats;
+	game.cascadeDepth = 0;
+}
+
+void GameSession::render()
+{
+	pimpl->game.render(pimpl->clock.getTicks());
+}
+
+bool GameSession::isGameStarted() const
+{
+	return pimpl->game.gameStarted;
+}
+
+int GameSession::getTimeLeft() const
+{
+	return pimpl->game.timeLeftSeconds;
+}
+
+int GameSession::getScore() const
+{
+	return pimpl->game.score;
+}
+
+const GameStats &GameSession::getStats() const
+{
+	return pimpl->game.stats;
+}
+
+const Board &GameSession::getBoard() const
+{
+	return *pimpl->game.board;
+}
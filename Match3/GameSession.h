@@ -0,0 +1,48 @@
+#ifndef _GAME_SESSION_H_
+#define _GAME_SESSION_H_
+
+#include "Game.h"
+#include "Platform.h"
+
+template<int Rows, int Columns, int Types>
+struct BasicBoard;
+typedef BasicBoard<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> Board;
+struct GameSessionCheckpoint;
+struct Move;
+
+//headless game driven explicitly by its owner: game time moves only through
+//step(), so a session runs as fast as CPU allows and doesn't need SDL
+class GameSession
+{
+	struct					impl;
+	std::unique_ptr<impl>	pimpl;
+public:
+	GameSession(Renderer &r, unsigned int seed);
+	~GameSession();
+
+	unsigned int getTime() const;
+	//start new game without clicking the board, return false during post game pause
+	bool start();
+	void applyInput(const InputEvent &e);
+	//swap blocks directly, bypassing mouse input; false if swap doesn't kill
+	bool trySwap(const Move &move);
+	//advance game time by dt milliseconds
+	void advance(unsigned int dt);
+	//one frame of game logic at current time
+	void simulate();
+	//advance() and simulate()
+	void step(unsigned int dt);
+	//checkpoints can be taken only while board is settled
+	bool saveCheckpoint(GameSessionCheckpoint &checkpoint) const;
+	void loadCheckpoint(const GameSessionCheckpoint &checkpoint);
+	void render();
+
+	bool isGameStarted() const;
+	int getTimeLeft() const;
+	int getScore() const;
+	const GameStats &getStats() const;
+	//read only view for move policies
+	const Board &getBoard() const;
+};
+
+#endif
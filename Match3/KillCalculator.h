@@ -1,17 +1,31 @@
 #ifndef _KILL_CALCULATOR_H_
 #define _KILL_CALCULATOR_H_
 
-class KillCalculator
+//common interface of kill search engines, both are built from a board and
+//mark blocks belonging to horizontal or vertical runs of three or more
+template<int Rows, int Columns, int Types>
+class BasicKillSearch
 {
-	int						blockTypes[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS];
-	bool					blockKills[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS];
+public:
+	virtual ~BasicKillSearch() {}
+
+	virtual void swapTypes(int srcX, int srcY, int dstX, int dstY) = 0;
+	virtual void calculateKills() = 0;
+	virtual bool hasKills() const = 0;
+	virtual bool hasKillAt(int x, int y) const = 0;
+};
+
+//bitboard engine
+template<int Rows, int Columns, int Types>
+class BasicKillCalculator : public BasicKillSearch<Rows, Columns, Types>
+{
+	typedef BasicBitBoard<Rows, Columns, Types>		BitBoardT;
+	typedef typename BitBoardT::Mask				Mask;
 
-	void initBlockTypes(const Board &board);
-	int getBlockType(int x, int y) const;
-	bool verticalKillSearch(int x, int y) const;
-	bool horizontalKillSearch(int x, int y) const;
+	BitBoardT				bitBoard;
+	Mask					blockKills;
 public:
-	KillCalculator(const Board &board);
+	BasicKillCalculator(const BasicBoard<Rows, Columns, Types> &board);
 
 	void swapTypes(int srcX, int srcY, int dstX, int dstY);
 	void calculateKills();
@@ -19,4 +33,12 @@ public:
 	bool hasKillAt(int x, int y) const;
 };
 
+typedef BasicKillCalculator<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> KillCalculator;
+
+//score for blocks killed together in one kill pass
+inline int killScore(int killCount)
+{
+	return 2 + (killCount - 1) * (killCount - 2) / 2;
+}
+
 #endif
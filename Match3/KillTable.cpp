@@ -1,82 +1,142 @@
 #include "GameImpl.h"
 
-KillTable::KillTable(BlockPtr blocks[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS])
-{
-	ITERATE_ALL_BEGIN
-		blockKills[i][j] = false;
-	ITERATE_ALL_END
-	initBlockTypes(blocks);
-}
+template<int Rows, int Columns, int Types>
+constexpr LineKillTable<Columns> BasicKillTable<Rows, Columns, Types>::ROW_TABLE;
 
-void KillTable::initBlockTypes(BlockPtr blocks[NUM_BLOCK_ROWS][NUM_BLOCK_COLUMNS])
+template<int Rows, int Columns, int Types>
+constexpr LineKillTable<Rows> BasicKillTable<Rows, Columns, Types>::COLUMN_TABLE;
+
+template<int Rows, int Columns, int Types>
+BasicKillTable<Rows, Columns, Types>::BasicKillTable(const BasicBoard<Rows, Columns, Types> &board)
 {
-	ITERATE_ALL_BEGIN
-		if(!blocks[i][j])
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
 		{
-			blockTypes[i][j] = -1;
+			blockTypes[i][j] = (int8_t)board.blockTypes.get(j, i);
 		}
-		else
+	}
+	for(int i = 0; i < Rows; ++i)
+	{
+		rowPairs[i] = 0;
+		rowKills[i] = 0;
+	}
+	for(int j = 0; j < Columns; ++j)
+	{
+		columnPairs[j] = 0;
+		columnKills[j] = 0;
+	}
+	for(int i = 0; i < Rows; ++i)
+	{
+		for(int j = 0; j < Columns; ++j)
 		{
-			blockTypes[i][j] = blocks[i][j]->getType();
+			updatePairs(j, i);
 		}
-	ITERATE_ALL_END
+	}
 }
 
-int KillTable::getBlockType(int x, int y) const
+template<int Rows, int Columns, int Types>
+int BasicKillTable<Rows, Columns, Types>::getBlockType(int x, int y) const
 {
-	if(y < 0 || y >= NUM_BLOCK_ROWS ||
-		x < 0 || x >= NUM_BLOCK_COLUMNS)
+	if(y < 0 || y >= Rows ||
+		x < 0 || x >= Columns)
 	{
 		return -1;
 	}
 	return blockTypes[y][x];
 }
 
-void KillTable::swapTypes(int srcX, int srcY, int dstX, int dstY)
+template<int Rows, int Columns, int Types>
+void BasicKillTable<Rows, Columns, Types>::updatePairs(int x, int y)
 {
-	std::swap(blockTypes[dstY][dstX], blockTypes[srcY][srcX]);
-}
-
-void KillTable::calculateKills()
-{
-	ITERATE_ALL_BEGIN
-		if(getBlockType(j, i) == -1)
+	//callers only pass cells on the board; the check also gives GCC the
+	//index range, without it -O3 warns falsely about columnPairs[x]
+	if((unsigned int)x >= (unsigned int)Columns || (unsigned int)y >= (unsigned int)Rows)
+	{
+		return;
+	}
+	const int type = blockTypes[y][x];
+	if(x + 1 < Columns)
+	{
+		const uint16_t bit = (uint16_t)(1 << x);
+		if(type != -1 && type == getBlockType(x + 1, y))
+		{
+			rowPairs[y] |= bit;
+		}
+		else
 		{
-			continue;
+			rowPairs[y] &= (uint16_t)~bit;
 		}
-		//horizontal search
-		for(int baseX = 0; baseX <= 2; ++baseX)
+	}
+	if(y + 1 < Rows)
+	{
+		const uint16_t bit = (uint16_t)(1 << y);
+		if(type != -1 && type == getBlockType(x, y + 1))
 		{
-			if((getBlockType(j + baseX - 2, i) == getBlockType(j + baseX - 1, i)) &&
-				(getBlockType(j + baseX - 1, i) == getBlockType(j + baseX, i)))
-			{
-				blockKills[i][j] = true;
-			}
+			columnPairs[x] |= bit;
 		}
-		//vertical search
-		for(int baseY = 0; baseY <= 2; ++baseY)
+		else
 		{
-			if((getBlockType(j, i + baseY - 2) == getBlockType(j, i + baseY - 1)) &&
-				(getBlockType(j, i + baseY - 1) == getBlockType(j, i + baseY)))
-			{
-				blockKills[i][j] = true;
-			}
+			columnPairs[x] &= (uint16_t)~bit;
 		}
-	ITERATE_ALL_END
+	}
 }
 
-bool KillTable::hasKills() const
+template<int Rows, int Columns, int Types>
+void BasicKillTable<Rows, Columns, Types>::setType(int x, int y, int type)
 {
-	ITERATE_ALL_BEGIN
-		if(blockKills[i][j])
-		{
-			return true;
-		}
-	ITERATE_ALL_END
-	return false;
+	blockTypes[y][x] = (int8_t)type;
+	updatePairs(x, y);
+	if(x > 0)
+	{
+		updatePairs(x - 1, y);
+	}
+	if(y > 0)
+	{
+		updatePairs(x, y - 1);
+	}
+}
+
+template<int Rows, int Columns, int Types>
+void BasicKillTable<Rows, Columns, Types>::swapTypes(int srcX, int srcY, int dstX, int dstY)
+{
+	const int srcType = blockTypes[srcY][srcX];
+	setType(srcX, srcY, blockTypes[dstY][dstX]);
+	setType(dstX, dstY, srcType);
+}
+
+template<int Rows, int Columns, int Types>
+void BasicKillTable<Rows, Columns, Types>::calculateKills()
+{
+	for(int i = 0; i < Rows; ++i)
+	{
+		rowKills[i] = ROW_TABLE.kills[rowPairs[i]];
+	}
+	for(int j = 0; j < Columns; ++j)
+	{
+		columnKills[j] = COLUMN_TABLE.kills[columnPairs[j]];
+	}
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicKillTable<Rows, Columns, Types>::hasKills() const
+{
+	uint16_t kills = 0;
+	for(int i = 0; i < Rows; ++i)
+	{
+		kills |= rowKills[i];
+	}
+	for(int j = 0; j < Columns; ++j)
+	{
+		kills |= columnKills[j];
+	}
+	return kills != 0;
 }
 
-bool KillTable::hasKillAt(int x, int y) const
+template<int Rows, int Columns, int Types>
+bool BasicKillTable<Rows, Columns, Types>::hasKillAt(int x, int y) const
 {
-	return blockKills[y][x];
+	return ((rowKills[y] >> x) & 1) || ((columnKills[x] >> y) & 1);
 }
+
+INSTANTIATE_BOARD_GEOMETRIES(class BasicKillTable)
@@ -0,0 +1,63 @@
+#ifndef _KILL_TABLE_H_
+#define _KILL_TABLE_H_
+
+//kill masks of a line of Length cells, indexed by the pattern of equal
+//neighbors (bit k set if cells k and k + 1 hold the same block type)
+template<int Length>
+struct LineKillTable
+{
+	static const int SIZE = 1 << (Length - 1);
+
+	uint16_t				kills[SIZE];
+
+	constexpr LineKillTable() :
+	kills()
+	{
+		for(int pattern = 0; pattern < SIZE; ++pattern)
+		{
+			for(int k = 0; k + 2 < Length; ++k)
+			{
+				//two equal pairs next to each other are a run of three
+				if(((pattern >> k) & 3) == 3)
+				{
+					kills[pattern] = (uint16_t)(kills[pattern] | (7 << k));
+				}
+			}
+		}
+	}
+};
+
+//table driven engine: every row and column keeps its equal neighbor
+//pattern up to date as types change, so a full board check is one table
+//lookup per row and per column
+template<int Rows, int Columns, int Types>
+class BasicKillTable : public BasicKillSearch<Rows, Columns, Types>
+{
+	static_assert(Rows <= 16 && Columns <= 16, "line masks are 16 bit");
+
+	static constexpr LineKillTable<Columns> ROW_TABLE = LineKillTable<Columns>();
+	static constexpr LineKillTable<Rows> COLUMN_TABLE = LineKillTable<Rows>();
+
+	int8_t					blockTypes[Rows][Columns];
+	uint16_t				rowPairs[Rows];
+	uint16_t				columnPairs[Columns];
+	//bit x of row y / bit y of column x set for killed blocks
+	uint16_t				rowKills[Rows];
+	uint16_t				columnKills[Columns];
+
+	int getBlockType(int x, int y) const;
+	//recalculate pair bits between (x, y) and its right/lower neighbor
+	void updatePairs(int x, int y);
+	void setType(int x, int y, int type);
+public:
+	BasicKillTable(const BasicBoard<Rows, Columns, Types> &board);
+
+	void swapTypes(int srcX, int srcY, int dstX, int dstY);
+	void calculateKills();
+	bool hasKills() const;
+	bool hasKillAt(int x, int y) const;
+};
+
+typedef BasicKillTable<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> KillTable;
+
+#endif
@@ -0,0 +1,16 @@
+#include "Platform.h"
+
+ManualClock::ManualClock(unsigned int startTime) :
+ticks(startTime)
+{
+}
+
+unsigned int ManualClock::getTicks()
+{
+	return ticks;
+}
+
+void ManualClock::advance(unsigned int dt)
+{
+	ticks += dt;
+}
@@ -0,0 +1,52 @@
+#include "GameImpl.h"
+
+template<int Rows, int Columns, int Types>
+BasicMoveGenerator<Rows, Columns, Types>::BasicMoveGenerator(const BitBoardT &bitBoard)
+{
+	bitBoard.findMoves(rightMoves, downMoves);
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicMoveGenerator<Rows, Columns, Types>::hasAnyMove() const
+{
+	return !BitBoardT::Ops::isZero(rightMoves | downMoves);
+}
+
+template<int Rows, int Columns, int Types>
+int BasicMoveGenerator<Rows, Columns, Types>::countMoves() const
+{
+	return BitBoardT::Ops::popCount(rightMoves) + BitBoardT::Ops::popCount(downMoves);
+}
+
+template<int Rows, int Columns, int Types>
+bool BasicMoveGenerator<Rows, Columns, Types>::getHint(Move &move) const
+{
+	return getMoves(&move, 1) == 1;
+}
+
+template<int Rows, int Columns, int Types>
+int BasicMoveGenerator<Rows, Columns, Types>::getMoves(Move *moves, int maxMoves) const
+{
+	typedef typename BitBoardT::Ops Ops;
+	int count = 0;
+	Mask cells = rightMoves | downMoves;
+	while(!Ops::isZero(cells) && count < maxMoves)
+	{
+		const int cell = Ops::lowestBit(cells);
+		const Mask bit = Ops::bit(cell);
+		cells ^= bit;
+		const int x = cell % Columns;
+		const int y = cell / Columns;
+		if(!Ops::isZero(rightMoves & bit))
+		{
+			moves[count++] = { x, y, x + 1, y };
+		}
+		if(!Ops::isZero(downMoves & bit) && count < maxMoves)
+		{
+			moves[count++] = { x, y, x, y + 1 };
+		}
+	}
+	return count;
+}
+
+INSTANTIATE_BOARD_GEOMETRIES(class BasicMoveGenerator)
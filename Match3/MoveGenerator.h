@@ -0,0 +1,32 @@
+#ifndef _MOVE_GENERATOR_H_
+#define _MOVE_GENERATOR_H_
+
+//lists killing swaps of a position using pattern masks over the bitboard,
+//every pair of neighbor blocks is covered by a single pass over block types
+template<int Rows, int Columns, int Types>
+class BasicMoveGenerator
+{
+	typedef BasicBitBoard<Rows, Columns, Types>		BitBoardT;
+	typedef typename BitBoardT::Mask				Mask;
+
+	//bit of (x, y) set if swap with right/lower neighbor kills
+	Mask					rightMoves;
+	Mask					downMoves;
+public:
+	//upper bound of moves in any position
+	static const int MAX_MOVES = 2 * Rows * Columns;
+
+	BasicMoveGenerator(const BitBoardT &bitBoard);
+
+	bool hasAnyMove() const;
+	int countMoves() const;
+	//first move in board order, false if there are no moves
+	bool getHint(Move &move) const;
+	//moves in board order (rows top to bottom, right swap before down swap
+	//of the same cell), return number of moves written
+	int getMoves(Move *moves, int maxMoves = MAX_MOVES) const;
+};
+
+typedef BasicMoveGenerator<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> MoveGenerator;
+
+#endif
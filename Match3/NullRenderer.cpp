@@ -12,6 +12,10 @@ void NullRenderer::clear()
 {
 }
 
+void NullRenderer::beginLayer()
+{
+}
+
 void NullRenderer::setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
 {
 }
@@ -0,0 +1,107 @@
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+enum class InputEventType
+{
+	Quit,
+	MouseDown,
+	MouseUp,
+	MouseMotion,
+};
+
+struct InputEvent
+{
+	InputEventType		type;
+	int					x;
+	int					y;
+};
+
+//source of game time in milliseconds
+class Clock
+{
+public:
+	virtual ~Clock() {}
+
+	virtual unsigned int getTicks() = 0;
+};
+
+class EventSource
+{
+public:
+	virtual ~EventSource() {}
+
+	//return false if there are no more pending events
+	virtual bool pollEvent(InputEvent &e) = 0;
+	//block until an event is pending or timeout milliseconds pass
+	virtual void waitEvent(unsigned int timeout) = 0;
+	//make waitEvent() return early, may be called from any thread
+	virtual void wake() = 0;
+	//false while window is hidden or minimized, nothing has to be drawn then
+	virtual bool isVisible() = 0;
+	//true once after window contents were lost and have to be drawn again
+	virtual bool checkExposed() = 0;
+};
+
+class SDLClock : public Clock
+{
+public:
+	unsigned int getTicks();
+};
+
+class SDLEventSource : public EventSource
+{
+	//window state follows window events seen by pollEvent()
+	bool				visible;
+	bool				exposed;
+public:
+	SDLEventSource();
+
+	bool pollEvent(InputEvent &e);
+	void waitEvent(unsigned int timeout);
+	void wake();
+	bool isVisible();
+	bool checkExposed();
+};
+
+//events handed over from the thread owning the window to the game logic
+//thread; window contents are redrawn by the owning thread itself, so
+//exposure never reaches game logic
+class QueuedEventSource : public EventSource
+{
+	std::mutex				mutex;
+	std::condition_variable	pending;
+	std::vector<InputEvent>	queue;
+	size_t					next;
+	bool					woken;
+	std::atomic<bool>		visible;
+public:
+	QueuedEventSource();
+
+	//producer side
+	void push(const InputEvent &e);
+	void setVisible(bool v);
+
+	bool pollEvent(InputEvent &e);
+	void waitEvent(unsigned int timeout);
+	void wake();
+	bool isVisible();
+	bool checkExposed();
+};
+
+//clock advanced explicitly by its owner, for headless simulation
+class ManualClock : public Clock
+{
+	unsigned int		ticks;
+public:
+	ManualClock(unsigned int startTime = 0);
+
+	unsigned int getTicks();
+	void advance(unsigned int dt);
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+std::atomic<bool> Profiler::enabled(false);
+
+//ring of one thread; fields are relaxed atomics so readers racing with
+//the writer see stale or new values but never undefined ones, the
+//write count tells them which slots are valid
+struct ProfileRing
+{
+	struct Slot
+	{
+		std::atomic<const char*>	name;
+		std::atomic<uint64_t>		start;
+		std::atomic<uint64_t>		duration;
+		std::atomic<int>			depth;
+	};
+
+	Slot					slots[Profiler::RING_SIZE];
+	//events ever written
+	std::atomic<uint64_t>	count;
+	//rings of finished threads are reused by new ones
+	std::atomic<bool>		owned;
+	int						thread;
+	ProfileRing				*next;
+
+	void read(std::vector<ProfileEvent> &events) const;
+};
+
+//rings are never freed, so readers can walk the list without locks
+static std::atomic<ProfileRing*> rings(nullptr);
+static std::atomic<int> ringCount(0);
+
+void ProfileRing::read(std::vector<ProfileEvent> &events) const
+{
+	const uint64_t stop = count.load(std::memory_order_acquire);
+	uint64_t first = stop > Profiler::RING_SIZE ? stop - Profiler::RING_SIZE : 0;
+	const size_t begin = events.size();
+	for(uint64_t i = first; i < stop; ++i)
+	{
+		const Slot &slot = slots[i % Profiler::RING_SIZE];
+		ProfileEvent e;
+		e.name = slot.name.load(std::memory_order_relaxed);
+		e.start = slot.start.load(std::memory_order_relaxed);
+		e.duration = slot.duration.load(std::memory_order_relaxed);
+		e.depth = slot.depth.load(std::memory_order_relaxed);
+		e.thread = thread;
+		events.push_back(e);
+	}
+	//writer may have been writing event number now (not counted yet) and
+	//everything before it while slots were copied, so slots of events
+	//now - RING_SIZE and older are not trustworthy
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const uint64_t now = count.load(std::memory_order_relaxed);
+	if(now + 1 > first + Profiler::RING_SIZE)
+	{
+		const uint64_t drop = std::min<uint64_t>(now + 1 - Profiler::RING_SIZE - first, stop - first);
+		events.erase(events.begin() + begin, events.begin() + begin + (size_t)drop);
+	}
+}
+
+//gives the thread a ring on its first event and back when it exits
+struct ProfileRingOwner
+{
+	ProfileRing				*ring;
+	int						depth;
+
+	ProfileRingOwner() :
+	ring(nullptr),
+	depth(0)
+	{
+	}
+
+	~ProfileRingOwner()
+	{
+		if(ring)
+		{
+			ring->owned.store(false, std::memory_order_release);
+		}
+	}
+
+	ProfileRing *get()
+	{
+		if(!ring)
+		{
+			ring = acquire();
+		}
+		return ring;
+	}
+
+	static ProfileRing *acquire()
+	{
+		for(ProfileRing *r = rings.load(std::memory_order_acquire); r; r = r->next)
+		{
+			bool expected = false;
+			if(r->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+			{
+				return r;
+			}
+		}
+		ProfileRing *r = new ProfileRing;
+		r->count.store(0, std::memory_order_relaxed);
+		r->owned.store(true, std::memory_order_relaxed);
+		r->thread = ringCount.fetch_add(1, std::memory_order_relaxed);
+		r->next = rings.load(std::memory_order_relaxed);
+		while(!rings.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+		return r;
+	}
+};
+
+static thread_local ProfileRingOwner ringOwner;
+
+void Profiler::setEnabled(bool enable)
+{
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int &Profiler::currentDepth()
+{
+	return ringOwner.depth;
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t stop, int depth)
+{
+	ProfileRing *ring = ringOwner.get();
+	const uint64_t index = ring->count.load(std::memory_order_relaxed);
+	ProfileRing::Slot &slot = ring->slots[index % RING_SIZE];
+	slot.name.store(name, std::memory_order_relaxed);
+	slot.start.store(start, std::memory_order_relaxed);
+	slot.duration.store(stop - start, std::memory_order_relaxed);
+	slot.depth.store(depth, std::memory_order_relaxed);
+	ring->count.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::getLastScope(const char *name, std::vector<ProfileEvent> &events)
+{
+	events.clear();
+	const ProfileRing *ring = ringOwner.ring;
+	if(!ring)
+	{
+		return false;
+	}
+	//own ring can't change under us; scopes are recorded when they end,
+	//so the ones nested in the last scope called name are right before it
+	const uint64_t stop = ring->count.load(std::memory_order_relaxed);
+	const uint64_t first = stop > RING_SIZE ? stop - RING_SIZE : 0;
+	auto load = [&] (uint64_t index) -> ProfileEvent {
+		const ProfileRing::Slot &slot = ring->slots[index % RING_SIZE];
+		ProfileEvent e;
+		e.name = slot.name.load(std::memory_order_relaxed);
+		e.start = slot.start.load(std::memory_order_relaxed);
+		e.duration = slot.duration.load(std::memory_order_relaxed);
+		e.depth = slot.depth.load(std::memory_order_relaxed);
+		e.thread = ring->thread;
+		return e;
+	};
+	for(uint64_t i = stop; i-- > first; )
+	{
+		const ProfileEvent scope = load(i);
+		if(strcmp(scope.name, name))
+		{
+			continue;
+		}
+		events.push_back(scope);
+		for(uint64_t j = i; j-- > first; )
+		{
+			ProfileEvent e = load(j);
+			if(e.depth <= scope.depth || e.start < scope.start)
+			{
+				break;
+			}
+			events.push_back(e);
+		}
+		std::sort(events.begin() + 1, events.end(), [] (const ProfileEvent &a, const ProfileEvent &b) -> bool {
+			return a.start < b.start;
+		});
+		return true;
+	}
+	return false;
+}
+
+void Profiler::getAllEvents(std::vector<ProfileEvent> &events)
+{
+	events.clear();
+	for(ProfileRing *r = rings.load(std::memory_order_acquire); r; r = r->next)
+	{
+		r->read(events);
+	}
+}
+
+void Profiler::writeChromeTrace(std::ostream &out)
+{
+	std::vector<ProfileEvent> events;
+	getAllEvents(events);
+	uint64_t origin = events.empty() ? 0 : events[0].start;
+	for(const ProfileEvent &e : events)
+	{
+		origin = std::min(origin, e.start);
+	}
+
+	//complete events, timestamps in microseconds
+	out << "{\"traceEvents\": [";
+	out << std::fixed << std::setprecision(3);
+	for(size_t i = 0; i < events.size(); ++i)
+	{
+		const ProfileEvent &e = events[i];
+		out << (i ? ",\n" : "\n") << "{\"name\": \"" << e.name << "\", \"cat\": \"match3\", \"ph\": \"X\", \"ts\": "
+			<< (e.start - origin) / 1000.0 << ", \"dur\": " << e.duration / 1000.0
+			<< ", \"pid\": 1, \"tid\": " << e.thread << "}";
+	}
+	out << "\n], \"displayTimeUnit\": \"ms\"}" << std::endl;
+}
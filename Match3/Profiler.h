@@ -0,0 +1,88 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+//finished profiling scope, times are nanoseconds of a monotonic clock
+struct ProfileEvent
+{
+	//string literal
+	const char				*name;
+	uint64_t				start;
+	uint64_t				duration;
+	//number of enclosing scopes on the same thread
+	int						depth;
+	int						thread;
+};
+
+//scoped timers recording into per-thread rings: every thread owns one ring
+//and is its only writer, so recording takes no locks; readers copy events
+//out and drop the ones the owner overwrote meanwhile
+class Profiler
+{
+	static std::atomic<bool>	enabled;
+public:
+	//events kept per thread, older ones are overwritten
+	static const int RING_SIZE = 4096;
+
+	static bool isEnabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+	static void setEnabled(bool enable);
+
+	static uint64_t now();
+	static void record(const char *name, uint64_t start, uint64_t stop, int depth);
+	//nesting depth of scopes open on calling thread
+	static int &currentDepth();
+
+	//last finished scope called name on calling thread followed by
+	//scopes nested in it in start order; false if there is none in the ring
+	static bool getLastScope(const char *name, std::vector<ProfileEvent> &events);
+	//events still in the rings of all threads
+	static void getAllEvents(std::vector<ProfileEvent> &events);
+	//chrome://tracing / Perfetto trace_event format
+	static void writeChromeTrace(std::ostream &out);
+};
+
+class ProfileScope
+{
+	const char				*name;
+	uint64_t				start;
+public:
+	ProfileScope(const char *n) :
+	name(n),
+	start(0)
+	{
+		if(Profiler::isEnabled())
+		{
+			start = Profiler::now();
+			Profiler::currentDepth()++;
+		}
+	}
+
+	~ProfileScope()
+	{
+		if(start)
+		{
+			int depth = --Profiler::currentDepth();
+			Profiler::record(name, start, Profiler::now(), depth);
+		}
+	}
+};
+
+//name has to be a string literal; builds defining MATCH3_NO_PROFILER
+//compile scopes out completely, otherwise a disabled profiler costs
+//one relaxed load per scope
+#ifdef MATCH3_NO_PROFILER
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#endif
+
+#endif
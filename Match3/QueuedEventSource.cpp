@@ -0,0 +1,65 @@
+#include "Platform.h"
+#include <chrono>
+
+QueuedEventSource::QueuedEventSource() :
+next(0),
+woken(false),
+visible(true)
+{
+}
+
+void QueuedEventSource::push(const InputEvent &e)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue.push_back(e);
+	}
+	pending.notify_one();
+}
+
+void QueuedEventSource::setVisible(bool v)
+{
+	visible.store(v, std::memory_order_relaxed);
+}
+
+bool QueuedEventSource::pollEvent(InputEvent &e)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if(next == queue.size())
+	{
+		//capacity is kept for the following events
+		queue.clear();
+		next = 0;
+		return false;
+	}
+	e = queue[next++];
+	return true;
+}
+
+void QueuedEventSource::waitEvent(unsigned int timeout)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	pending.wait_for(lock, std::chrono::milliseconds(timeout), [this] {
+		return woken || next != queue.size();
+	});
+	woken = false;
+}
+
+void QueuedEventSource::wake()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		woken = true;
+	}
+	pending.notify_one();
+}
+
+bool QueuedEventSource::isVisible()
+{
+	return visible.load(std::memory_order_relaxed);
+}
+
+bool QueuedEventSource::checkExposed()
+{
+	return false;
+}
@@ -2,8 +2,11 @@
 #ifndef _RENDERER_H_
 #define _RENDERER_H_
 
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <string>
+#include <vector>
 
 enum TextureID {
 	TID_BACKGROUND,
@@ -26,6 +29,9 @@ class Renderer
 {
 public:
 	virtual void clear() = 0;
+	//draws of a layer may be reordered among themselves (e.g. batched by
+	//texture) as long as they don't overlap, layers are drawn in order
+	virtual void beginLayer() = 0;
 	virtual void setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a) = 0;
 	virtual void setClipRect(int x, int y, int w, int h) = 0;
 	virtual void resetClipRect() = 0;
@@ -47,6 +53,52 @@ public:
 	~SDLRenderer();
 
 	void clear();
+	void beginLayer();
+	void setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+	void setClipRect(int x, int y, int w, int h);
+	void resetClipRect();
+	void drawBackground(TextureID tid);
+	void drawTexture(TextureID tid, int x, int y);
+	void drawTextureCentered(TextureID tid, int x, int y, int w, int h, double scale = 1.0);
+	void drawFilledRectangle(int x, int y, int w, int h);
+	void drawText(const char *text, int x, int y);
+	void present();
+};
+
+//RGBA image, one byte per channel in R, G, B, A order, rows tightly packed
+struct SoftwareImage
+{
+	int						width;
+	int						height;
+	std::vector<uint32_t>	pixels;
+
+	SoftwareImage();
+	SoftwareImage(int w, int h);
+	//uncompressed 32 bit TGA, viewable without any image library
+	void writeTGA(std::ostream &out) const;
+};
+
+//draws into an in-memory framebuffer on the CPU, so frames can be produced
+//without a window or GPU; draws go straight to the framebuffer in call order,
+//textures and glyphs are plain images supplied by the owner
+class SoftwareRenderer : public Renderer
+{
+	struct					impl;
+	std::unique_ptr<impl>	pimpl;
+
+public:
+	SoftwareRenderer(int width, int height);
+	~SoftwareRenderer();
+
+	void setTexture(TextureID tid, const SoftwareImage &image);
+	//white glyph with coverage in alpha, drawn with its top left corner
+	//at pen position; pen moves right by advance
+	void setGlyph(char c, const SoftwareImage &image, int advance);
+	//framebuffer as of last present()
+	const SoftwareImage &getFrame() const;
+
+	void clear();
+	void beginLayer();
 	void setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
 	void setClipRect(int x, int y, int w, int h);
 	void resetClipRect();
@@ -66,6 +118,7 @@ public:
 	~NullRenderer();
 
 	void clear();
+	void beginLayer();
 	void setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
 	void setClipRect(int x, int y, int w, int h);
 	void resetClipRect();
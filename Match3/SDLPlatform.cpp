@@ -0,0 +1,90 @@
+#include <SDL.h>
+
+#include "Platform.h"
+
+unsigned int SDLClock::getTicks()
+{
+	return SDL_GetTicks();
+}
+
+SDLEventSource::SDLEventSource() :
+visible(true),
+exposed(true)
+{
+}
+
+bool SDLEventSource::pollEvent(InputEvent &e)
+{
+	SDL_Event sdlEvent;
+	while(SDL_PollEvent(&sdlEvent))
+	{
+		switch(sdlEvent.type)
+		{
+			case SDL_QUIT:
+			//case SDL_KEYDOWN:
+				e.type = InputEventType::Quit;
+				e.x = e.y = 0;
+				return true;
+			case SDL_MOUSEBUTTONDOWN:
+				e.type = InputEventType::MouseDown;
+				e.x = sdlEvent.button.x;
+				e.y = sdlEvent.button.y;
+				return true;
+			case SDL_MOUSEMOTION:
+				e.type = InputEventType::MouseMotion;
+				e.x = sdlEvent.motion.x;
+				e.y = sdlEvent.motion.y;
+				return true;
+			case SDL_MOUSEBUTTONUP:
+				e.type = InputEventType::MouseUp;
+				e.x = sdlEvent.button.x;
+				e.y = sdlEvent.button.y;
+				return true;
+			case SDL_WINDOWEVENT:
+				switch(sdlEvent.window.event)
+				{
+					case SDL_WINDOWEVENT_HIDDEN:
+					case SDL_WINDOWEVENT_MINIMIZED:
+						visible = false;
+						break;
+					case SDL_WINDOWEVENT_SHOWN:
+					case SDL_WINDOWEVENT_RESTORED:
+						visible = true;
+						exposed = true;
+						break;
+					case SDL_WINDOWEVENT_EXPOSED:
+						exposed = true;
+						break;
+				}
+				break;
+		}
+	}
+	return false;
+}
+
+void SDLEventSource::waitEvent(unsigned int timeout)
+{
+	//event is left in the queue for pollEvent()
+	SDL_WaitEventTimeout(nullptr, (int)timeout);
+}
+
+void SDLEventSource::wake()
+{
+	//SDL_PushEvent is thread safe, pollEvent() drops user events
+	SDL_Event sdlEvent;
+	SDL_zero(sdlEvent);
+	sdlEvent.type = SDL_USEREVENT;
+	SDL_PushEvent(&sdlEvent);
+}
+
+bool SDLEventSource::isVisible()
+{
+	return visible;
+}
+
+bool SDLEventSource::checkExposed()
+{
+	bool result = exposed;
+	exposed = false;
+	return result;
+}
@@ -1,13 +1,30 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <vector>
 
 #include "Renderer.h"
+#include "DrawCommandBuffer.h"
 
 const int WIN_WIDTH = 755;
 const int WIN_HEIGHT = 600;
+//printable ASCII is rasterized into the glyph atlas, anything else is drawn as '?'
+const int FIRST_GLYPH = 32;
+const int LAST_GLYPH = 126;
+const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+//sprites of glyphs follow the TextureID ones
+const int FIRST_GLYPH_SPRITE = TID_LAST;
+const unsigned char TEXT_ALPHA = 225;
+//laid out strings kept for drawing again, longer ones are laid out every time
+const int TEXT_CACHE_SIZE = 16;
+const int MAX_CACHED_TEXT = 47;
+//atlas rows are filled up to this width
+const int ATLAS_MAX_WIDTH = 2048;
+//empty pixels around every atlas sprite, so filtering doesn't bleed neighbors in
+const int ATLAS_PADDING = 1;
 
 static const char *textureNames[] = {
 	"../assets/RS_bg.jpg",
@@ -18,19 +35,65 @@ static const char *textureNames[] = {
 	"../assets/RS_gem_yellow.png",
 };
 
+//where a TextureID or glyph image lives, computed once at load time
+struct Sprite
+{
+	//index into SDLRenderer::impl::textures
+	int							texture;
+	SDL_Rect					source;
+	SDL_FPoint					uv0;
+	SDL_FPoint					uv1;
+};
+
+//glyph positions of a string drawn at (0, 0)
+struct TextLayout
+{
+	char						text[MAX_CACHED_TEXT + 1];
+	int							length;
+	int16_t						glyphX[MAX_CACHED_TEXT];
+	//frame the layout was last drawn in, least recent one gets replaced
+	unsigned int				lastUse;
+};
+
 struct SDLRenderer::impl
 {
 	SDL_Window					*win;
 	SDL_Renderer				*ren;
+	//background, the atlas all gems are packed into and the glyph atlas
 	std::vector<SDL_Texture*>	textures;
+	Sprite						sprites[TID_LAST + GLYPH_COUNT];
 	TTF_Font					*defaultFont;
+	int							glyphAdvance[GLYPH_COUNT];
+	TextLayout					textCache[TEXT_CACHE_SIZE];
+	unsigned int				frame;
+
+	//draws are collected and submitted in bulk by submit()
+	DrawCommandBuffer			commands;
+	std::vector<SDL_Vertex>		vertices;
+	std::vector<int>			indices;
 
 	impl();
 	~impl();
 
 	void validateTexture(TextureID tid);
+	void loadTextures();
+	//add loaded texture as a sprite covering all of it
+	void addTexture(TextureID tid, SDL_Texture *texture);
+	//pack images into one texture, surfaces are freed
+	void buildAtlas(const std::vector<int> &spriteIndices, std::vector<SDL_Surface*> &images);
+	//rasterize every glyph of defaultFont once
+	void loadGlyphs();
+	static int glyphIndex(char c);
+	//cached layout of text, nullptr if it is too long to cache
+	const TextLayout *findTextLayout(const char *text);
+	void drawGlyph(int glyph, int x, int y);
+	//sort pending commands and draw them with one SDL_RenderGeometry
+	//call per run of commands sharing texture, blend mode and clip rect
+	void submit();
+	void setSDLClipRect(const DrawClipRect &clip);
 
 	void clear();
+	void beginLayer();
 	void setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
 	void setClipRect(int x, int y, int w, int h);
 	void resetClipRect();
@@ -46,7 +109,8 @@ struct SDLRenderer::impl
 SDLRenderer::impl::impl() :
 win(nullptr),
 ren(nullptr),
-defaultFont(nullptr)
+defaultFont(nullptr),
+frame(0)
 {
 	std::ostringstream errorStream;
 	if(SDL_Init(SDL_INIT_EVERYTHING) != 0)
@@ -69,18 +133,7 @@ defaultFont(nullptr)
 		throw new RendererException(errorStream.str());
 	}
 
-	static_assert(TID_LAST == sizeof(textureNames)/sizeof(char*), "textureNames array size must match TextureID enumeration!");
-
-	for(int i = 0; i < TID_LAST; ++i)
-	{
-		SDL_Texture *tex = IMG_LoadTexture(ren, textureNames[i]);
-		if(nullptr == tex)
-		{
-			errorStream << "IMG_LoadTexture Error: " << SDL_GetError();
-			throw new RendererException(errorStream.str());
-		}
-		textures.push_back(tex);
-	}
+	loadTextures();
 
 	//init ttf font
 	if(TTF_Init() != 0)
@@ -95,6 +148,14 @@ defaultFont(nullptr)
 		errorStream << "Font loading error.";
 		throw new RendererException(errorStream.str());
 	}
+	loadGlyphs();
+
+	for(TextLayout &layout : textCache)
+	{
+		layout.text[0] = 0;
+		layout.length = -1;
+		layout.lastUse = 0;
+	}
 }
 
 SDLRenderer::impl::~impl()
@@ -116,6 +177,203 @@ SDLRenderer::impl::~impl()
 	SDL_Quit();
 }
 
+void SDLRenderer::impl::loadTextures()
+{
+	static_assert(TID_LAST == sizeof(textureNames)/sizeof(char*), "textureNames array size must match TextureID enumeration!");
+
+	std::ostringstream errorStream;
+	SDL_Texture *background = IMG_LoadTexture(ren, textureNames[TID_BACKGROUND]);
+	if(nullptr == background)
+	{
+		errorStream << "IMG_LoadTexture Error: " << SDL_GetError();
+		throw new RendererException(errorStream.str());
+	}
+	addTexture(TID_BACKGROUND, background);
+
+	std::vector<int> gems;
+	std::vector<SDL_Surface*> images;
+	for(int i = TID_BLOCK_1; i < TID_LAST; ++i)
+	{
+		SDL_Surface *loaded = IMG_Load(textureNames[i]);
+		SDL_Surface *image = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+		if(loaded)
+		{
+			SDL_FreeSurface(loaded);
+		}
+		if(nullptr == image)
+		{
+			for(SDL_Surface *s : images)
+			{
+				SDL_FreeSurface(s);
+			}
+			errorStream << "IMG_Load Error: " << SDL_GetError();
+			throw new RendererException(errorStream.str());
+		}
+		gems.push_back(i);
+		images.push_back(image);
+	}
+	buildAtlas(gems, images);
+}
+
+void SDLRenderer::impl::addTexture(TextureID tid, SDL_Texture *texture)
+{
+	Sprite &sprite = sprites[tid];
+	sprite.texture = (int)textures.size();
+	sprite.source.x = sprite.source.y = 0;
+	SDL_QueryTexture(texture, NULL, NULL, &sprite.source.w, &sprite.source.h);
+	sprite.uv0.x = sprite.uv0.y = 0.0f;
+	sprite.uv1.x = sprite.uv1.y = 1.0f;
+	textures.push_back(texture);
+}
+
+void SDLRenderer::impl::buildAtlas(const std::vector<int> &spriteIndices, std::vector<SDL_Surface*> &images)
+{
+	//shelf packing in load order: images go left to right, a new row
+	//starts below the tallest image of the row when it gets too wide
+	int x = ATLAS_PADDING, y = ATLAS_PADDING, rowHeight = 0;
+	int atlasWidth = 0, atlasHeight = 0;
+	for(size_t i = 0; i < images.size(); ++i)
+	{
+		SDL_Surface *image = images[i];
+		if(x > ATLAS_PADDING && x + image->w + ATLAS_PADDING > ATLAS_MAX_WIDTH)
+		{
+			x = ATLAS_PADDING;
+			y += rowHeight + ATLAS_PADDING;
+			rowHeight = 0;
+		}
+		SDL_Rect &source = sprites[spriteIndices[i]].source;
+		source.x = x;
+		source.y = y;
+		source.w = image->w;
+		source.h = image->h;
+		x += image->w + ATLAS_PADDING;
+		rowHeight = std::max(rowHeight, image->h);
+		atlasWidth = std::max(atlasWidth, x);
+		atlasHeight = std::max(atlasHeight, y + rowHeight + ATLAS_PADDING);
+	}
+
+	SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32);
+	SDL_Texture *texture = nullptr;
+	if(atlas)
+	{
+		for(size_t i = 0; i < images.size(); ++i)
+		{
+			//copy pixels as they are, alpha included
+			SDL_SetSurfaceBlendMode(images[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(images[i], NULL, atlas, &sprites[spriteIndices[i]].source);
+		}
+		texture = SDL_CreateTextureFromSurface(ren, atlas);
+		SDL_FreeSurface(atlas);
+	}
+	for(SDL_Surface *image : images)
+	{
+		SDL_FreeSurface(image);
+	}
+	images.clear();
+	if(nullptr == texture)
+	{
+		std::ostringstream errorStream;
+		errorStream << "Texture atlas Error: " << SDL_GetError();
+		throw new RendererException(errorStream.str());
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	const int atlasIndex = (int)textures.size();
+	textures.push_back(texture);
+	for(int index : spriteIndices)
+	{
+		Sprite &sprite = sprites[index];
+		sprite.texture = atlasIndex;
+		sprite.uv0.x = sprite.source.x / (float)atlasWidth;
+		sprite.uv0.y = sprite.source.y / (float)atlasHeight;
+		sprite.uv1.x = (sprite.source.x + sprite.source.w) / (float)atlasWidth;
+		sprite.uv1.y = (sprite.source.y + sprite.source.h) / (float)atlasHeight;
+	}
+}
+
+void SDLRenderer::impl::loadGlyphs()
+{
+	//glyphs are white and fully opaque, text alpha is applied when drawing
+	SDL_Color white;
+	white.r = white.g = white.b = white.a = 255;
+	std::vector<int> glyphSprites;
+	std::vector<SDL_Surface*> images;
+	for(int i = 0; i < GLYPH_COUNT; ++i)
+	{
+		const Uint16 c = (Uint16)(FIRST_GLYPH + i);
+		int minX, maxX, minY, maxY;
+		SDL_Surface *rendered = TTF_RenderGlyph_Blended(defaultFont, c, white);
+		SDL_Surface *image = rendered ? SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+		if(rendered)
+		{
+			SDL_FreeSurface(rendered);
+		}
+		if(nullptr == image || TTF_GlyphMetrics(defaultFont, c, &minX, &maxX, &minY, &maxY, &glyphAdvance[i]) != 0)
+		{
+			if(image)
+			{
+				SDL_FreeSurface(image);
+			}
+			for(SDL_Surface *s : images)
+			{
+				SDL_FreeSurface(s);
+			}
+			std::ostringstream errorStream;
+			errorStream << "Glyph rendering error: " << SDL_GetError();
+			throw new RendererException(errorStream.str());
+		}
+		glyphSprites.push_back(FIRST_GLYPH_SPRITE + i);
+		images.push_back(image);
+	}
+	buildAtlas(glyphSprites, images);
+}
+
+int SDLRenderer::impl::glyphIndex(char c)
+{
+	const int code = (unsigned char)c;
+	return (code >= FIRST_GLYPH && code <= LAST_GLYPH) ? code - FIRST_GLYPH : '?' - FIRST_GLYPH;
+}
+
+const TextLayout *SDLRenderer::impl::findTextLayout(const char *text)
+{
+	const size_t length = strlen(text);
+	if(length > (size_t)MAX_CACHED_TEXT)
+	{
+		return nullptr;
+	}
+	TextLayout *oldest = &textCache[0];
+	for(TextLayout &layout : textCache)
+	{
+		if(layout.length == (int)length && !memcmp(layout.text, text, length))
+		{
+			layout.lastUse = frame;
+			return &layout;
+		}
+		if(layout.lastUse < oldest->lastUse)
+		{
+			oldest = &layout;
+		}
+	}
+
+	TextLayout &layout = *oldest;
+	memcpy(layout.text, text, length + 1);
+	layout.length = (int)length;
+	layout.lastUse = frame;
+	int penX = 0;
+	for(size_t i = 0; i < length; ++i)
+	{
+		layout.glyphX[i] = (int16_t)penX;
+		penX += glyphAdvance[glyphIndex(text[i])];
+	}
+	return &layout;
+}
+
+void SDLRenderer::impl::drawGlyph(int glyph, int x, int y)
+{
+	const Sprite &sprite = sprites[FIRST_GLYPH_SPRITE + glyph];
+	commands.drawTexture(sprite.texture, FIRST_GLYPH_SPRITE + glyph, x, y, sprite.source.w, sprite.source.h, TEXT_ALPHA);
+}
+
 void SDLRenderer::impl::validateTexture(TextureID tid)
 {
 	if(tid >= TID_LAST || tid < 0)
@@ -126,105 +384,165 @@ void SDLRenderer::impl::validateTexture(TextureID tid)
 	}
 }
 
+void SDLRenderer::impl::setSDLClipRect(const DrawClipRect &clip)
+{
+	if(!clip.enabled)
+	{
+		SDL_RenderSetClipRect(ren, NULL);
+		return;
+	}
+	SDL_Rect cr;
+	cr.x = clip.x;
+	cr.y = clip.y;
+	cr.w = clip.w;
+	cr.h = clip.h;
+	SDL_RenderSetClipRect(ren, &cr);
+}
+
+void SDLRenderer::impl::submit()
+{
+	commands.sort();
+	int currentClip = -1;
+	for(size_t first = 0; first < commands.size(); )
+	{
+		const size_t count = commands.getBatchSize(first);
+		const DrawCommand &batch = commands[first];
+		if(batch.clip != currentClip)
+		{
+			currentClip = batch.clip;
+			setSDLClipRect(commands.getClipRect(currentClip));
+		}
+		SDL_Texture *texture = nullptr;
+		if(batch.texture != NO_TEXTURE)
+		{
+			texture = textures[batch.texture];
+		}
+		else
+		{
+			//untextured geometry uses renderer blend mode
+			SDL_SetRenderDrawBlendMode(ren, batch.blend == DrawBlend::Alpha ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+		}
+
+		vertices.resize(count * 4);
+		indices.resize(count * 6);
+		for(size_t i = 0; i < count; ++i)
+		{
+			const DrawCommand &c = commands[first + i];
+			SDL_Vertex *v = &vertices[i * 4];
+			const float x0 = c.x, y0 = c.y, x1 = (float)(c.x + c.w), y1 = (float)(c.y + c.h);
+			const float xs[4] = { x0, x1, x1, x0 };
+			const float ys[4] = { y0, y0, y1, y1 };
+			const Sprite &sprite = sprites[c.sprite];
+			const float us[4] = { sprite.uv0.x, sprite.uv1.x, sprite.uv1.x, sprite.uv0.x };
+			const float vs[4] = { sprite.uv0.y, sprite.uv0.y, sprite.uv1.y, sprite.uv1.y };
+			for(int k = 0; k < 4; ++k)
+			{
+				v[k].position.x = xs[k];
+				v[k].position.y = ys[k];
+				v[k].color.r = c.r;
+				v[k].color.g = c.g;
+				v[k].color.b = c.b;
+				v[k].color.a = c.a;
+				v[k].tex_coord.x = us[k];
+				v[k].tex_coord.y = vs[k];
+			}
+			int *index = &indices[i * 6];
+			const int base = (int)i * 4;
+			index[0] = base;
+			index[1] = base + 1;
+			index[2] = base + 2;
+			index[3] = base;
+			index[4] = base + 2;
+			index[5] = base + 3;
+		}
+		SDL_RenderGeometry(ren, texture, vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+		first += count;
+	}
+	commands.clear();
+	//draws bypassing the buffer see the clip rect they were issued with
+	setSDLClipRect(commands.getCurrentClipRect());
+}
+
 void SDLRenderer::impl::clear()
 {
+	commands.reset();
+	SDL_RenderSetClipRect(ren, NULL);
 	SDL_RenderClear(ren);
 }
 
+void SDLRenderer::impl::beginLayer()
+{
+	commands.beginLayer();
+}
+
 void SDLRenderer::impl::setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
 {
-	SDL_SetRenderDrawColor(ren, r, g, b, a);
-	SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+	commands.setColor(r, g, b, a);
 }
 
 void SDLRenderer::impl::setClipRect(int x, int y, int w, int h)
 {
-	SDL_Rect cr;
-	cr.x = x;
-	cr.y = y;
-	cr.w = w;
-	cr.h = h;
-	SDL_RenderSetClipRect(ren, &cr);
+	commands.setClipRect(x, y, w, h);
 }
 
 void SDLRenderer::impl::resetClipRect()
 {
-	SDL_RenderSetClipRect(ren, NULL);
+	commands.resetClipRect();
 }
 
 void SDLRenderer::impl::drawBackground(TextureID tid)
 {
 	validateTexture(tid);
-	SDL_RenderCopy(ren, textures[tid], NULL, NULL);
+	commands.drawTexture(sprites[tid].texture, tid, 0, 0, WIN_WIDTH, WIN_HEIGHT);
 }
 
 void SDLRenderer::impl::drawTexture(TextureID tid, int x, int y)
 {
 	validateTexture(tid);
-	SDL_Rect dst;
-	dst.x = x;
-	dst.y = y;
-	SDL_QueryTexture(textures[tid], NULL, NULL, &dst.w, &dst.h);
-	SDL_RenderCopy(ren, textures[tid], NULL, &dst);
+	const Sprite &sprite = sprites[tid];
+	commands.drawTexture(sprite.texture, tid, x, y, sprite.source.w, sprite.source.h);
 }
 
 void SDLRenderer::impl::drawTextureCentered(TextureID tid, int x, int y, int w, int h, double scale)
 {
 	validateTexture(tid);
-	int textureWidth, textureHeight;
-	SDL_QueryTexture(textures[tid], NULL, NULL, &textureWidth, &textureHeight);
-
-	textureWidth = (int)(textureWidth * scale);
-	textureHeight = (int)(textureHeight * scale);
+	const Sprite &sprite = sprites[tid];
+	int textureWidth = (int)(sprite.source.w * scale);
+	int textureHeight = (int)(sprite.source.h * scale);
 
-	SDL_Rect dst;
-	dst.x = x + (w - textureWidth) / 2;
-	dst.y = y + (h - textureHeight) / 2;
-	dst.w = textureWidth;
-	dst.h = textureHeight;
-	SDL_RenderCopy(ren, textures[tid], NULL, &dst);
+	commands.drawTexture(sprite.texture, tid, x + (w - textureWidth) / 2, y + (h - textureHeight) / 2, textureWidth, textureHeight);
 }
 
 void SDLRenderer::impl::drawFilledRectangle(int x, int y, int w, int h)
 {
-	SDL_Rect rectangle;
-
-	rectangle.x = x;
-	rectangle.y = y;
-	rectangle.w = w;
-	rectangle.h = h;
-	SDL_RenderFillRect(ren, &rectangle);
+	commands.drawFilledRectangle(x, y, w, h);
 }
 
 void SDLRenderer::impl::drawText(const char *text, int x, int y)
 {
-	SDL_Color col;
-	col.r = col.g = col.b = 255;
-	col.a = 225;
-	SDL_Surface *surf = TTF_RenderText_Blended(defaultFont, text, col);
-	if(nullptr == surf)
+	//glyph quads from the atlas, no surfaces or textures are created
+	const TextLayout *layout = findTextLayout(text);
+	if(layout)
 	{
+		for(int i = 0; i < layout->length; ++i)
+		{
+			drawGlyph(glyphIndex(text[i]), x + layout->glyphX[i], y);
+		}
 		return;
 	}
-	SDL_Texture *texture = SDL_CreateTextureFromSurface(ren, surf);
-	if(nullptr == texture)
+	for(int penX = x; *text; ++text)
 	{
-		return;
+		const int glyph = glyphIndex(*text);
+		drawGlyph(glyph, penX, y);
+		penX += glyphAdvance[glyph];
 	}
-	SDL_FreeSurface(surf);
-
-	SDL_Rect dst;
-	dst.x = x;
-	dst.y = y;
-	SDL_QueryTexture(texture, NULL, NULL, &dst.w, &dst.h);
-	SDL_RenderCopy(ren, texture, NULL, &dst);
-
-	SDL_DestroyTexture(texture);
 }
 
 void SDLRenderer::impl::present()
 {
+	submit();
 	SDL_RenderPresent(ren);
+	frame++;
 }
 
 SDLRenderer::SDLRenderer()
@@ -241,6 +559,11 @@ void SDLRenderer::clear()
 	pimpl->clear();
 }
 
+void SDLRenderer::beginLayer()
+{
+	pimpl->beginLayer();
+}
+
 void SDLRenderer::setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
 {
 	pimpl->setColor(r, g, b, a);
@@ -0,0 +1,305 @@
+#include "GameImpl.h"
+#include "GameSession.h"
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <ostream>
+
+static const char RECORD_MAGIC[4] = { 'M', '3', 'R', '1' };
+
+//record kinds, input events are InputEventType + 1
+static const int RECORD_FRAME = 0;
+static const int RECORD_KIND_BITS = 3;
+
+static uint64_t zigzag(int value)
+{
+	return ((uint64_t)(int64_t)value << 1) ^ (uint64_t)((int64_t)value >> 63);
+}
+
+static int unzigzag(uint64_t value)
+{
+	return (int)(int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+SessionRecorder::SessionRecorder(std::ostream &o) :
+out(o),
+lastTime(0),
+lastFlushTime(0)
+{
+}
+
+void SessionRecorder::writeVarint(uint64_t value)
+{
+	while(value >= 0x80)
+	{
+		buffer.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back((uint8_t)value);
+}
+
+void SessionRecorder::writeRecord(unsigned int time, int kind)
+{
+	writeVarint(((uint64_t)(time - lastTime) << RECORD_KIND_BITS) | kind);
+	lastTime = time;
+}
+
+void SessionRecorder::flush()
+{
+	out.write((const char*)buffer.data(), buffer.size());
+	out.flush();
+	buffer.clear();
+	lastFlushTime = lastTime;
+}
+
+void SessionRecorder::begin(unsigned int seed)
+{
+	buffer.insert(buffer.end(), RECORD_MAGIC, RECORD_MAGIC + sizeof(RECORD_MAGIC));
+	writeVarint(seed);
+	lastTime = 0;
+	flush();
+}
+
+void SessionRecorder::input(unsigned int time, const InputEvent &e)
+{
+	writeRecord(time, (int)e.type + 1);
+	writeVarint(zigzag(e.x));
+	writeVarint(zigzag(e.y));
+}
+
+void SessionRecorder::frame(unsigned int time)
+{
+	writeRecord(time, RECORD_FRAME);
+	if(lastTime - lastFlushTime >= FLUSH_INTERVAL)
+	{
+		flush();
+	}
+}
+
+void SessionRecorder::end()
+{
+	flush();
+}
+
+struct SessionPlayer::impl
+{
+	//session state at the beginning of a record
+	struct Checkpoint
+	{
+		size_t					offset;
+		GameSessionCheckpoint	session;
+	};
+
+	Renderer				&renderer;
+	std::vector<uint8_t>	data;
+	size_t					headerSize;
+	size_t					offset;
+	unsigned int			seed;
+	unsigned int			time;
+	unsigned int			checkpointInterval;
+	//last played record was a frame
+	bool					framePlayed;
+	std::unique_ptr<GameSession>	session;
+	//in time order
+	std::vector<Checkpoint>	checkpoints;
+
+	impl(Renderer &r, std::istream &in, unsigned int interval);
+
+	bool readVarint(size_t &position, uint64_t &value) const;
+	//time of next record, false at the end of record
+	bool peekTime(unsigned int &nextTime) const;
+	bool step();
+	//back to the state right after the header
+	void rewind();
+};
+
+SessionPlayer::impl::impl(Renderer &r, std::istream &in, unsigned int interval) :
+renderer(r),
+data(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()),
+checkpointInterval(interval)
+{
+	uint64_t value;
+	headerSize = sizeof(RECORD_MAGIC);
+	if(data.size() < headerSize || !std::equal(RECORD_MAGIC, RECORD_MAGIC + sizeof(RECORD_MAGIC), data.begin())
+		|| !readVarint(headerSize, value))
+	{
+		throw new ReplayException("not a session record");
+	}
+	seed = (unsigned int)value;
+	rewind();
+}
+
+bool SessionPlayer::impl::readVarint(size_t &position, uint64_t &value) const
+{
+	value = 0;
+	for(int shift = 0; position < data.size() && shift < 64; shift += 7)
+	{
+		uint8_t byte = data[position++];
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if(!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SessionPlayer::impl::peekTime(unsigned int &nextTime) const
+{
+	size_t position = offset;
+	uint64_t header;
+	if(!readVarint(position, header))
+	{
+		return false;
+	}
+	nextTime = time + (unsigned int)(header >> RECORD_KIND_BITS);
+	return true;
+}
+
+bool SessionPlayer::impl::step()
+{
+	//records cut short at the end are dropped
+	size_t position = offset;
+	uint64_t header, x = 0, y = 0;
+	if(!readVarint(position, header))
+	{
+		return false;
+	}
+	const int kind = (int)(header & ((1 << RECORD_KIND_BITS) - 1));
+	if(kind != RECORD_FRAME && (!readVarint(position, x) || !readVarint(position, y)))
+	{
+		return false;
+	}
+	if(kind > (int)InputEventType::MouseMotion + 1)
+	{
+		throw new ReplayException("unknown record kind");
+	}
+	offset = position;
+	time += (unsigned int)(header >> RECORD_KIND_BITS);
+	session->advance(time - session->getTime());
+	framePlayed = (kind == RECORD_FRAME);
+
+	if(kind == RECORD_FRAME)
+	{
+		session->simulate();
+		//replaying after a backward seek passes times that already have
+		//checkpoints, only times past the last one add more so they stay sorted
+		if(checkpoints.empty() || time >= checkpoints.back().session.time + checkpointInterval)
+		{
+			Checkpoint checkpoint;
+			checkpoint.offset = offset;
+			if(session->saveCheckpoint(checkpoint.session))
+			{
+				checkpoints.push_back(checkpoint);
+			}
+		}
+	}
+	else
+	{
+		InputEvent e;
+		e.type = (InputEventType)(kind - 1);
+		e.x = unzigzag(x);
+		e.y = unzigzag(y);
+		session->applyInput(e);
+	}
+	return true;
+}
+
+void SessionPlayer::impl::rewind()
+{
+	session.reset(new GameSession(renderer, seed));
+	offset = headerSize;
+	time = 0;
+	framePlayed = false;
+}
+
+SessionPlayer::SessionPlayer(Renderer &r, std::istream &in, unsigned int checkpointInterval)
+{
+	pimpl = std::unique_ptr<impl>(new impl(r, in, checkpointInterval));
+}
+
+SessionPlayer::~SessionPlayer()
+{
+}
+
+unsigned int SessionPlayer::getSeed() const
+{
+	return pimpl->seed;
+}
+
+unsigned int SessionPlayer::getTime() const
+{
+	return pimpl->time;
+}
+
+bool SessionPlayer::isFinished() const
+{
+	unsigned int nextTime;
+	return !pimpl->peekTime(nextTime);
+}
+
+int SessionPlayer::getCheckpointCount() const
+{
+	return (int)pimpl->checkpoints.size();
+}
+
+GameSession &SessionPlayer::getSession()
+{
+	return *pimpl->session;
+}
+
+bool SessionPlayer::step()
+{
+	return pimpl->step();
+}
+
+bool SessionPlayer::playFrame()
+{
+	while(pimpl->step())
+	{
+		if(pimpl->framePlayed)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void SessionPlayer::playUntil(unsigned int time)
+{
+	unsigned int nextTime;
+	while(pimpl->peekTime(nextTime) && nextTime <= time && pimpl->step())
+	{
+	}
+}
+
+void SessionPlayer::playAll()
+{
+	while(pimpl->step())
+	{
+	}
+}
+
+void SessionPlayer::seek(unsigned int time)
+{
+	if(time < pimpl->time)
+	{
+		auto &checkpoints = pimpl->checkpoints;
+		auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), time,
+			[] (unsigned int t, const impl::Checkpoint &c) -> bool {
+				return t < c.session.time;
+			});
+		if(it == checkpoints.begin())
+		{
+			pimpl->rewind();
+		}
+		else
+		{
+			--it;
+			pimpl->offset = it->offset;
+			pimpl->time = it->session.time;
+			pimpl->session->loadCheckpoint(it->session);
+		}
+	}
+	playUntil(time);
+}
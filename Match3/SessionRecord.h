@@ -0,0 +1,78 @@
+#ifndef _SESSION_RECORD_H_
+#define _SESSION_RECORD_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+//session record: "M3R1" magic and varint board seed followed by one record
+//per input event and per frame, every record starts with varint of
+//(time since previous record << 3 | kind), input events continue with
+//zigzag varint mouse coordinates; the stream is append only, so
+//a record cut short by a crash loses at most the last flush interval
+
+struct ReplayException : public std::exception
+{
+	std::string			error;
+
+	ReplayException(const std::string &error) : error(error) {};
+};
+
+class SessionRecorder
+{
+	std::ostream			&out;
+	std::vector<uint8_t>	buffer;
+	unsigned int			lastTime;
+	unsigned int			lastFlushTime;
+
+	void writeVarint(uint64_t value);
+	void writeRecord(unsigned int time, int kind);
+	void flush();
+public:
+	//game time between writes to out, in milliseconds
+	static const unsigned int FLUSH_INTERVAL = 1000;
+
+	SessionRecorder(std::ostream &out);
+
+	void begin(unsigned int seed);
+	void input(unsigned int time, const InputEvent &e);
+	//game logic was simulated at time
+	void frame(unsigned int time);
+	void end();
+};
+
+class GameSession;
+
+//plays a session record back into a headless session as fast as CPU allows,
+//checkpoints are taken while playing so seeking back doesn't start over
+class SessionPlayer
+{
+	struct					impl;
+	std::unique_ptr<impl>	pimpl;
+public:
+	//whole record is read from in, checkpointInterval is in game milliseconds
+	SessionPlayer(Renderer &r, std::istream &in, unsigned int checkpointInterval = 1000);
+	~SessionPlayer();
+
+	unsigned int getSeed() const;
+	//time of last played record
+	unsigned int getTime() const;
+	bool isFinished() const;
+	int getCheckpointCount() const;
+	GameSession &getSession();
+
+	//play next record, false at the end of record
+	bool step();
+	//play input records up to and including next frame record,
+	//false if the record ends before it
+	bool playFrame();
+	//play all records up to and including time
+	void playUntil(unsigned int time);
+	void playAll();
+	//restore latest checkpoint not after time, then play up to time
+	void seek(unsigned int time);
+};
+
+#endif
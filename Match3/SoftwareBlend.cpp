@@ -0,0 +1,242 @@
+#include "SoftwareBlend.h"
+#include "CpuFeatures.h"
+
+#ifdef MATCH3_X86
+#include <immintrin.h>
+#endif
+
+//x / 255 rounded to nearest, exact for x up to 255 * 255
+static inline unsigned int div255(unsigned int x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+static inline void blendPixel(uint8_t *d, const uint8_t *s, unsigned int a)
+{
+	for(int c = 0; c < 3; ++c)
+	{
+		d[c] = (uint8_t)div255(s[c] * a + d[c] * (255 - a));
+	}
+	d[3] = (uint8_t)div255(255 * a + d[3] * (255 - a));
+}
+
+void blendSpanScalar(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha)
+{
+	for(int i = 0; i < count; ++i)
+	{
+		const uint8_t *s = (const uint8_t*)&src[i];
+		blendPixel((uint8_t*)&dst[i], s, div255(s[3] * alpha));
+	}
+}
+
+void fillSpanScalar(uint32_t *dst, int count, uint32_t color)
+{
+	const uint8_t *s = (const uint8_t*)&color;
+	const unsigned int a = s[3];
+	for(int i = 0; i < count; ++i)
+	{
+		blendPixel((uint8_t*)&dst[i], s, a);
+	}
+}
+
+#ifdef MATCH3_X86
+
+//same rounding as div255() on 16 bit lanes
+MATCH3_TARGET_SSE2 static inline __m128i div255SSE2(__m128i x)
+{
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+//two pixels widened to 16 bit lanes
+MATCH3_TARGET_SSE2 static inline __m128i blendPixelsSSE2(__m128i s, __m128i d, __m128i alpha)
+{
+	const __m128i alphaLanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	const __m128i v255 = _mm_set1_epi16(255);
+	__m128i srcA = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	__m128i a = div255SSE2(_mm_mullo_epi16(srcA, alpha));
+	s = _mm_or_si128(s, alphaLanes);
+	__m128i t = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(v255, a)));
+	return div255SSE2(t);
+}
+
+MATCH3_TARGET_SSE2 void blendSpanSSE2(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaVec = _mm_set1_epi16(alpha);
+	const __m128i alphaMask = _mm_set1_epi32((int)0xff000000);
+	int i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)&src[i]);
+		//opaque pixels are copied and transparent ones leave dst as it is,
+		//both give the same result as blending
+		__m128i srcA = _mm_and_si128(s, alphaMask);
+		if(0xffff == _mm_movemask_epi8(_mm_cmpeq_epi32(srcA, zero)))
+		{
+			continue;
+		}
+		if(255 == alpha && 0xffff == _mm_movemask_epi8(_mm_cmpeq_epi32(srcA, alphaMask)))
+		{
+			_mm_storeu_si128((__m128i*)&dst[i], s);
+			continue;
+		}
+		__m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+		__m128i lo = blendPixelsSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), alphaVec);
+		__m128i hi = blendPixelsSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), alphaVec);
+		_mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+	}
+	blendSpanScalar(dst + i, src + i, count - i, alpha);
+}
+
+MATCH3_TARGET_SSE2 void fillSpanSSE2(uint32_t *dst, int count, uint32_t color)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const uint8_t *c = (const uint8_t*)&color;
+	const __m128i a = _mm_set1_epi16(c[3]);
+	const __m128i inverseA = _mm_set1_epi16(255 - c[3]);
+	//color part is the same for every pixel, alpha lane of source counts as 255
+	const __m128i s = _mm_or_si128(_mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero),
+		_mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+	const __m128i colorPart = _mm_mullo_epi16(s, a);
+	int i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+		__m128i lo = div255SSE2(_mm_add_epi16(colorPart, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inverseA)));
+		__m128i hi = div255SSE2(_mm_add_epi16(colorPart, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inverseA)));
+		_mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+	}
+	fillSpanScalar(dst + i, count - i, color);
+}
+
+MATCH3_TARGET_AVX2 static inline __m256i div255AVX2(__m256i x)
+{
+	x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+//unpack and pack work within 128 bit halves, so pixels come back in order
+MATCH3_TARGET_AVX2 static inline __m256i blendPixelsAVX2(__m256i s, __m256i d, __m256i alpha)
+{
+	const __m256i alphaLanes = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+	const __m256i v255 = _mm256_set1_epi16(255);
+	__m256i srcA = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	__m256i a = div255AVX2(_mm256_mullo_epi16(srcA, alpha));
+	s = _mm256_or_si256(s, alphaLanes);
+	__m256i t = _mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, _mm256_sub_epi16(v255, a)));
+	return div255AVX2(t);
+}
+
+MATCH3_TARGET_AVX2 void blendSpanAVX2(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaVec = _mm256_set1_epi16(alpha);
+	const __m256i alphaMask = _mm256_set1_epi32((int)0xff000000);
+	int i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)&src[i]);
+		__m256i srcA = _mm256_and_si256(s, alphaMask);
+		if(-1 == _mm256_movemask_epi8(_mm256_cmpeq_epi32(srcA, zero)))
+		{
+			continue;
+		}
+		if(255 == alpha && -1 == _mm256_movemask_epi8(_mm256_cmpeq_epi32(srcA, alphaMask)))
+		{
+			_mm256_storeu_si256((__m256i*)&dst[i], s);
+			continue;
+		}
+		__m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+		__m256i lo = blendPixelsAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), alphaVec);
+		__m256i hi = blendPixelsAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), alphaVec);
+		_mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+	}
+	blendSpanSSE2(dst + i, src + i, count - i, alpha);
+}
+
+MATCH3_TARGET_AVX2 void fillSpanAVX2(uint32_t *dst, int count, uint32_t color)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const uint8_t *c = (const uint8_t*)&color;
+	const __m256i a = _mm256_set1_epi16(c[3]);
+	const __m256i inverseA = _mm256_set1_epi16(255 - c[3]);
+	const __m256i s = _mm256_or_si256(_mm256_unpacklo_epi8(_mm256_set1_epi32((int)color), zero),
+		_mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0));
+	const __m256i colorPart = _mm256_mullo_epi16(s, a);
+	int i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+		__m256i lo = div255AVX2(_mm256_add_epi16(colorPart, _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inverseA)));
+		__m256i hi = div255AVX2(_mm256_add_epi16(colorPart, _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inverseA)));
+		_mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+	}
+	fillSpanSSE2(dst + i, count - i, color);
+}
+
+#else
+
+void blendSpanSSE2(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha)
+{
+	blendSpanScalar(dst, src, count, alpha);
+}
+
+void blendSpanAVX2(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha)
+{
+	blendSpanScalar(dst, src, count, alpha);
+}
+
+void fillSpanSSE2(uint32_t *dst, int count, uint32_t color)
+{
+	fillSpanScalar(dst, count, color);
+}
+
+void fillSpanAVX2(uint32_t *dst, int count, uint32_t color)
+{
+	fillSpanScalar(dst, count, color);
+}
+
+#endif
+
+//kernel is picked once
+static int getKernel()
+{
+	static const int kernel = cpuHasAVX2() ? 2 : (cpuHasSSE2() ? 1 : 0);
+	return kernel;
+}
+
+void blendSpan(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha)
+{
+	const int kernel = getKernel();
+	if(2 == kernel)
+	{
+		blendSpanAVX2(dst, src, count, alpha);
+	}
+	else if(1 == kernel)
+	{
+		blendSpanSSE2(dst, src, count, alpha);
+	}
+	else
+	{
+		blendSpanScalar(dst, src, count, alpha);
+	}
+}
+
+void fillSpan(uint32_t *dst, int count, uint32_t color)
+{
+	const int kernel = getKernel();
+	if(2 == kernel)
+	{
+		fillSpanAVX2(dst, count, color);
+	}
+	else if(1 == kernel)
+	{
+		fillSpanSSE2(dst, count, color);
+	}
+	else
+	{
+		fillSpanScalar(dst, count, color);
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef _SOFTWARE_BLEND_H_
+#define _SOFTWARE_BLEND_H_
+
+#include <cstdint>
+
+//span kernels of SoftwareRenderer on RGBA pixels (R, G, B, A byte order);
+//every kernel does the same integer math, so frames are bit exact whichever
+//one the CPU picks:
+//	a = srcA * alpha / 255
+//	dst = (src * a + dst * (255 - a)) / 255, with src alpha taken as 255
+//with every division by 255 rounded to nearest
+
+//src pixels over dst, their alpha modulated by alpha
+void blendSpanScalar(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha);
+void blendSpanSSE2(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha);
+void blendSpanAVX2(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha);
+//best kernel supported by the running CPU
+void blendSpan(uint32_t *dst, const uint32_t *src, int count, uint8_t alpha);
+
+//one color over count dst pixels
+void fillSpanScalar(uint32_t *dst, int count, uint32_t color);
+void fillSpanSSE2(uint32_t *dst, int count, uint32_t color);
+void fillSpanAVX2(uint32_t *dst, int count, uint32_t color);
+void fillSpan(uint32_t *dst, int count, uint32_t color);
+
+//pixel value of given channels in memory byte order
+inline uint32_t packRGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	uint32_t pixel;
+	uint8_t *bytes = (uint8_t*)&pixel;
+	bytes[0] = r;
+	bytes[1] = g;
+	bytes[2] = b;
+	bytes[3] = a;
+	return pixel;
+}
+
+#endif
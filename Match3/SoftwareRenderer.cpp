@@ -0,0 +1,323 @@
+#include "Renderer.h"
+#include "SoftwareBlend.h"
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+
+//printable ASCII, anything else is drawn as '?'
+const int FIRST_GLYPH = 32;
+const int LAST_GLYPH = 126;
+const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+//same as SDLRenderer
+const uint8_t TEXT_ALPHA = 225;
+
+SoftwareImage::SoftwareImage() :
+width(0),
+height(0)
+{
+}
+
+SoftwareImage::SoftwareImage(int w, int h) :
+width(w),
+height(h),
+pixels((size_t)w * h, 0)
+{
+}
+
+void SoftwareImage::writeTGA(std::ostream &out) const
+{
+	//top-left origin, 8 bits of alpha
+	const uint8_t header[18] = { 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		(uint8_t)width, (uint8_t)(width >> 8), (uint8_t)height, (uint8_t)(height >> 8), 32, 0x28 };
+	out.write((const char*)header, sizeof(header));
+	std::vector<uint8_t> row((size_t)width * 4);
+	for(int y = 0; y < height; ++y)
+	{
+		const uint8_t *src = (const uint8_t*)&pixels[(size_t)y * width];
+		//TGA stores BGRA
+		for(int x = 0; x < width; ++x)
+		{
+			row[x * 4] = src[x * 4 + 2];
+			row[x * 4 + 1] = src[x * 4 + 1];
+			row[x * 4 + 2] = src[x * 4];
+			row[x * 4 + 3] = src[x * 4 + 3];
+		}
+		out.write((const char*)row.data(), row.size());
+	}
+}
+
+struct SoftwareRenderer::impl
+{
+	//frame being drawn and last presented one
+	SoftwareImage				back;
+	SoftwareImage				front;
+	SoftwareImage				textures[TID_LAST];
+	//no transparent pixel in texture
+	bool						opaque[TID_LAST];
+	SoftwareImage				glyphs[GLYPH_COUNT];
+	int							glyphAdvance[GLYPH_COUNT];
+	uint32_t					color;
+	//clip rect already intersected with framebuffer, x1 and y1 exclusive
+	int							clipX0;
+	int							clipY0;
+	int							clipX1;
+	int							clipY1;
+	//clear() is done lazily by first draw, so an opaque background can replace it
+	bool						clearPending;
+	//per draw scratch of scaled draws, capacity is kept
+	std::vector<int>			sourceColumns;
+	std::vector<uint32_t>		scaledRow;
+
+	impl(int width, int height);
+
+	const SoftwareImage &getTexture(TextureID tid) const;
+	bool isClipReset() const;
+	void flushClear();
+	static int glyphIndex(char c);
+	//image stretched over (x, y, w, h) with nearest sampling, alpha modulates it
+	void drawImage(const SoftwareImage &image, int x, int y, int w, int h, uint8_t alpha);
+
+	void clear();
+	void setClipRect(int x, int y, int w, int h);
+	void resetClipRect();
+	void drawFilledRectangle(int x, int y, int w, int h);
+	void drawText(const char *text, int x, int y);
+};
+
+SoftwareRenderer::impl::impl(int width, int height) :
+back(width, height),
+front(width, height),
+color(packRGBA(0, 0, 0, 255)),
+clearPending(false)
+{
+	for(int i = 0; i < TID_LAST; ++i)
+	{
+		opaque[i] = false;
+	}
+	for(int i = 0; i < GLYPH_COUNT; ++i)
+	{
+		glyphAdvance[i] = 0;
+	}
+	resetClipRect();
+}
+
+const SoftwareImage &SoftwareRenderer::impl::getTexture(TextureID tid) const
+{
+	if(tid >= TID_LAST || tid < 0 || textures[tid].pixels.empty())
+	{
+		std::ostringstream errorStream;
+		errorStream << "Invalid texture id: "  << tid;
+		throw new RendererException(errorStream.str());
+	}
+	return textures[tid];
+}
+
+bool SoftwareRenderer::impl::isClipReset() const
+{
+	return 0 == clipX0 && 0 == clipY0 && back.width == clipX1 && back.height == clipY1;
+}
+
+void SoftwareRenderer::impl::flushClear()
+{
+	if(clearPending)
+	{
+		std::fill(back.pixels.begin(), back.pixels.end(), packRGBA(0, 0, 0, 255));
+		clearPending = false;
+	}
+}
+
+int SoftwareRenderer::impl::glyphIndex(char c)
+{
+	const int code = (unsigned char)c;
+	return (code >= FIRST_GLYPH && code <= LAST_GLYPH) ? code - FIRST_GLYPH : '?' - FIRST_GLYPH;
+}
+
+void SoftwareRenderer::impl::drawImage(const SoftwareImage &image, int x, int y, int w, int h, uint8_t alpha)
+{
+	const int x0 = std::max(x, clipX0);
+	const int y0 = std::max(y, clipY0);
+	const int x1 = std::min(x + w, clipX1);
+	const int y1 = std::min(y + h, clipY1);
+	if(x0 >= x1 || y0 >= y1 || image.pixels.empty())
+	{
+		return;
+	}
+	flushClear();
+	const int count = x1 - x0;
+	if(w == image.width && h == image.height)
+	{
+		for(int row = y0; row < y1; ++row)
+		{
+			blendSpan(&back.pixels[(size_t)row * back.width + x0],
+				&image.pixels[(size_t)(row - y) * image.width + (x0 - x)], count, alpha);
+		}
+		return;
+	}
+
+	//source pixel under the center of every destination pixel
+	sourceColumns.resize(count);
+	scaledRow.resize(count);
+	for(int i = 0; i < count; ++i)
+	{
+		sourceColumns[i] = (int)((2LL * (x0 + i - x) + 1) * image.width / (2LL * w));
+	}
+	for(int row = y0; row < y1; ++row)
+	{
+		const int sourceRow = (int)((2LL * (row - y) + 1) * image.height / (2LL * h));
+		const uint32_t *src = &image.pixels[(size_t)sourceRow * image.width];
+		for(int i = 0; i < count; ++i)
+		{
+			scaledRow[i] = src[sourceColumns[i]];
+		}
+		blendSpan(&back.pixels[(size_t)row * back.width + x0], scaledRow.data(), count, alpha);
+	}
+}
+
+void SoftwareRenderer::impl::clear()
+{
+	resetClipRect();
+	clearPending = true;
+}
+
+void SoftwareRenderer::impl::setClipRect(int x, int y, int w, int h)
+{
+	clipX0 = std::max(x, 0);
+	clipY0 = std::max(y, 0);
+	clipX1 = std::min(x + w, back.width);
+	clipY1 = std::min(y + h, back.height);
+}
+
+void SoftwareRenderer::impl::resetClipRect()
+{
+	setClipRect(0, 0, back.width, back.height);
+}
+
+void SoftwareRenderer::impl::drawFilledRectangle(int x, int y, int w, int h)
+{
+	const int x0 = std::max(x, clipX0);
+	const int y0 = std::max(y, clipY0);
+	const int x1 = std::min(x + w, clipX1);
+	const int y1 = std::min(y + h, clipY1);
+	if(x0 >= x1 || y0 >= y1)
+	{
+		return;
+	}
+	flushClear();
+	for(int row = y0; row < y1; ++row)
+	{
+		fillSpan(&back.pixels[(size_t)row * back.width + x0], x1 - x0, color);
+	}
+}
+
+void SoftwareRenderer::impl::drawText(const char *text, int x, int y)
+{
+	for(int penX = x; *text; ++text)
+	{
+		const int glyph = glyphIndex(*text);
+		const SoftwareImage &image = glyphs[glyph];
+		drawImage(image, penX, y, image.width, image.height, TEXT_ALPHA);
+		penX += glyphAdvance[glyph];
+	}
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+{
+	pimpl = std::unique_ptr<impl>(new impl(width, height));
+}
+
+SoftwareRenderer::~SoftwareRenderer()
+{
+}
+
+void SoftwareRenderer::setTexture(TextureID tid, const SoftwareImage &image)
+{
+	if(tid >= TID_LAST || tid < 0)
+	{
+		std::ostringstream errorStream;
+		errorStream << "Invalid texture id: "  << tid;
+		throw new RendererException(errorStream.str());
+	}
+	pimpl->textures[tid] = image;
+	pimpl->opaque[tid] = std::all_of(image.pixels.begin(), image.pixels.end(), [] (uint32_t pixel) {
+		return 255 == ((const uint8_t*)&pixel)[3];
+	});
+}
+
+void SoftwareRenderer::setGlyph(char c, const SoftwareImage &image, int advance)
+{
+	const int glyph = impl::glyphIndex(c);
+	pimpl->glyphs[glyph] = image;
+	pimpl->glyphAdvance[glyph] = advance;
+}
+
+const SoftwareImage &SoftwareRenderer::getFrame() const
+{
+	return pimpl->front;
+}
+
+void SoftwareRenderer::clear()
+{
+	pimpl->clear();
+}
+
+void SoftwareRenderer::beginLayer()
+{
+	//draws already land in call order
+}
+
+void SoftwareRenderer::setColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+	pimpl->color = packRGBA(r, g, b, a);
+}
+
+void SoftwareRenderer::setClipRect(int x, int y, int w, int h)
+{
+	pimpl->setClipRect(x, y, w, h);
+}
+
+void SoftwareRenderer::resetClipRect()
+{
+	pimpl->resetClipRect();
+}
+
+void SoftwareRenderer::drawBackground(TextureID tid)
+{
+	const SoftwareImage &image = pimpl->getTexture(tid);
+	//every pixel gets overwritten, nothing to clear
+	if(pimpl->opaque[tid] && pimpl->isClipReset())
+	{
+		pimpl->clearPending = false;
+	}
+	pimpl->drawImage(image, 0, 0, pimpl->back.width, pimpl->back.height, 255);
+}
+
+void SoftwareRenderer::drawTexture(TextureID tid, int x, int y)
+{
+	const SoftwareImage &image = pimpl->getTexture(tid);
+	pimpl->drawImage(image, x, y, image.width, image.height, 255);
+}
+
+void SoftwareRenderer::drawTextureCentered(TextureID tid, int x, int y, int w, int h, double scale)
+{
+	//same geometry as SDLRenderer
+	const SoftwareImage &image = pimpl->getTexture(tid);
+	int textureWidth = (int)(image.width * scale);
+	int textureHeight = (int)(image.height * scale);
+	pimpl->drawImage(image, x + (w - textureWidth) / 2, y + (h - textureHeight) / 2, textureWidth, textureHeight, 255);
+}
+
+void SoftwareRenderer::drawFilledRectangle(int x, int y, int w, int h)
+{
+	pimpl->drawFilledRectangle(x, y, w, h);
+}
+
+void SoftwareRenderer::drawText(const char *text, int x, int y)
+{
+	pimpl->drawText(text, x, y);
+}
+
+void SoftwareRenderer::present()
+{
+	pimpl->flushClear();
+	std::swap(pimpl->back, pimpl->front);
+}
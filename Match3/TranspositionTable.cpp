@@ -0,0 +1,97 @@
+#include "TranspositionTable.h"
+
+//data word layout: value 0-31, move 32-47, depth 48-55, generation 56-62,
+//bit 63 is always set so that used slots never hold zero data
+static const uint64_t USED_BIT = 1ull << 63;
+
+TranspositionTable::TranspositionTable(size_t megabytes) :
+bucketMask(0),
+generation(0)
+{
+	size_t count = 1;
+	while(count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+	{
+		count *= 2;
+	}
+	buckets = std::unique_ptr<Bucket[]>(new Bucket[count]);
+	bucketMask = count - 1;
+	clear();
+}
+
+void TranspositionTable::clear()
+{
+	for(uint64_t i = 0; i <= bucketMask; ++i)
+	{
+		for(int j = 0; j < ENTRIES_PER_BUCKET; ++j)
+		{
+			buckets[i].slots[j].check.store(0, std::memory_order_relaxed);
+			buckets[i].slots[j].data.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+void TranspositionTable::newSearch()
+{
+	generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t TranspositionTable::pack(const TranspositionEntry &entry, unsigned int generation)
+{
+	return (uint64_t)(uint32_t)entry.value |
+		((uint64_t)entry.move << 32) |
+		((uint64_t)entry.depth << 48) |
+		((uint64_t)(generation & 0x7f) << 56) |
+		USED_BIT;
+}
+
+void TranspositionTable::unpack(uint64_t data, TranspositionEntry &entry)
+{
+	entry.value = (int32_t)(uint32_t)data;
+	entry.move = (uint16_t)(data >> 32);
+	entry.depth = (uint8_t)(data >> 48);
+}
+
+bool TranspositionTable::probe(uint64_t key, TranspositionEntry &entry) const
+{
+	const Bucket &bucket = buckets[key & bucketMask];
+	for(int i = 0; i < ENTRIES_PER_BUCKET; ++i)
+	{
+		const uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+		const uint64_t check = bucket.slots[i].check.load(std::memory_order_relaxed);
+		if(data && (check ^ data) == key)
+		{
+			unpack(data, entry);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::store(uint64_t key, const TranspositionEntry &entry)
+{
+	const unsigned int currentGeneration = generation.load(std::memory_order_relaxed);
+	Bucket &bucket = buckets[key & bucketMask];
+	int victim = 0;
+	int victimScore = 0x7fffffff;
+	for(int i = 0; i < ENTRIES_PER_BUCKET; ++i)
+	{
+		const uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+		const uint64_t check = bucket.slots[i].check.load(std::memory_order_relaxed);
+		if(!data || (check ^ data) == key)
+		{
+			victim = i;
+			break;
+		}
+		//prefer replacing entries from old searches, then shallow ones
+		const int age = (int)((currentGeneration - (unsigned int)(data >> 56)) & 0x7f);
+		const int score = (int)((data >> 48) & 0xff) - 8 * age;
+		if(score < victimScore)
+		{
+			victimScore = score;
+			victim = i;
+		}
+	}
+	const uint64_t data = pack(entry, currentGeneration);
+	bucket.slots[victim].data.store(data, std::memory_order_relaxed);
+	bucket.slots[victim].check.store(key ^ data, std::memory_order_relaxed);
+}
@@ -0,0 +1,55 @@
+#ifndef _TRANSPOSITION_TABLE_H_
+#define _TRANSPOSITION_TABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+struct TranspositionEntry
+{
+	int32_t					value;
+	//search specific encoding of the best move
+	uint16_t				move;
+	//remaining search depth the value was calculated for
+	uint8_t					depth;
+};
+
+//fixed size hash table of search results shared by search threads without
+//locks: every entry is two atomic words, key xor data and data, so a torn
+//write by a racing thread just fails the key check on probe; buckets of
+//ENTRIES_PER_BUCKET entries share one cache line and the shallowest/oldest
+//entry gets replaced
+class TranspositionTable
+{
+	static const int ENTRIES_PER_BUCKET = 4;
+
+	struct Slot
+	{
+		std::atomic<uint64_t>	check;
+		std::atomic<uint64_t>	data;
+	};
+
+	struct alignas(64) Bucket
+	{
+		Slot					slots[ENTRIES_PER_BUCKET];
+	};
+
+	std::unique_ptr<Bucket[]>	buckets;
+	uint64_t					bucketMask;
+	std::atomic<unsigned int>	generation;
+
+	static uint64_t pack(const TranspositionEntry &entry, unsigned int generation);
+	static void unpack(uint64_t data, TranspositionEntry &entry);
+public:
+	//size is rounded down to a power of two buckets
+	TranspositionTable(size_t megabytes);
+
+	void clear();
+	//entries stored by earlier searches get replaced first
+	void newSearch();
+
+	bool probe(uint64_t key, TranspositionEntry &entry) const;
+	void store(uint64_t key, const TranspositionEntry &entry);
+};
+
+#endif
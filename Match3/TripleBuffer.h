@@ -0,0 +1,57 @@
+#ifndef _TRIPLE_BUFFER_H_
+#define _TRIPLE_BUFFER_H_
+
+#include <atomic>
+
+//hands the latest of a stream of values from one writer thread to one
+//reader thread without locks: writer fills its buffer and swaps it with
+//the middle one, reader swaps the middle one with its own only if it is
+//newer; neither of them ever waits, reader just skips stale values
+template<typename T>
+class TripleBuffer
+{
+	static const int INDEX_MASK = 3;
+	//set in middle while it holds a value reader hasn't taken yet
+	static const int FRESH = 4;
+
+	T						buffers[3];
+	std::atomic<int>		middle;
+	int						writeIndex;
+	int						readIndex;
+public:
+	TripleBuffer() :
+	middle(1),
+	writeIndex(0),
+	readIndex(2)
+	{
+	}
+
+	//writer side
+	T &getWriteBuffer()
+	{
+		return buffers[writeIndex];
+	}
+	//make write buffer the latest value, writer continues in another buffer
+	void publish()
+	{
+		writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	//reader side, false if nothing was published since last consume()
+	bool consume()
+	{
+		if(!(middle.load(std::memory_order_relaxed) & FRESH))
+		{
+			return false;
+		}
+		readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+	//latest consumed value, stays valid until next consume()
+	const T &getReadBuffer() const
+	{
+		return buffers[readIndex];
+	}
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef _TYPE_GRID_H_
+#define _TYPE_GRID_H_
+
+#include <cstdint>
+
+//smallest number of bits able to hold values 0...count - 1
+constexpr int bitsFor(int count, int bits = 1)
+{
+	return (1 << bits) >= count ? bits : bitsFor(count, bits + 1);
+}
+
+//block type of every cell packed into as few bits as block type count allows,
+//e.g. 3 bits per cell for up to 7 types, cells never straddle storage words
+template<int Rows, int Columns, int Types>
+struct PackedTypeGrid
+{
+	//value 0 is reserved for empty cells
+	static const int BITS_PER_CELL = bitsFor(Types + 1);
+	static const int CELLS_PER_WORD = 64 / BITS_PER_CELL;
+	static const int NUM_WORDS = (Rows * Columns + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+	static const uint64_t CELL_MASK = (uint64_t(1) << BITS_PER_CELL) - 1;
+
+	uint64_t				words[NUM_WORDS];
+
+	void clear()
+	{
+		for(int i = 0; i < NUM_WORDS; ++i)
+		{
+			words[i] = 0;
+		}
+	}
+
+	//type is block texture (TID_BLOCK_1...) or -1 for empty cell
+	int get(int x, int y) const
+	{
+		const int cell = y * Columns + x;
+		int value = (int)((words[cell / CELLS_PER_WORD] >> ((cell % CELLS_PER_WORD) * BITS_PER_CELL)) & CELL_MASK);
+		return value ? TID_BLOCK_1 + value - 1 : -1;
+	}
+
+	void set(int x, int y, int type)
+	{
+		const int cell = y * Columns + x;
+		const int shift = (cell % CELLS_PER_WORD) * BITS_PER_CELL;
+		uint64_t value = (type == -1) ? 0 : (uint64_t)(type - TID_BLOCK_1 + 1);
+		uint64_t &word = words[cell / CELLS_PER_WORD];
+		word = (word & ~(CELL_MASK << shift)) | (value << shift);
+	}
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef _ZOBRIST_H_
+#define _ZOBRIST_H_
+
+#include <cstdint>
+
+//64 bit keys of every (cell, block type) pair; hash of a position is the xor
+//of keys of all occupied cells, so changing one cell costs two xors
+template<int Rows, int Columns, int Types>
+class BasicZobrist
+{
+	struct KeyTable
+	{
+		uint64_t			keys[Rows * Columns][Types];
+
+		//splitmix64 sequence, fixed seed so hashes are stable between runs
+		constexpr KeyTable() :
+		keys()
+		{
+			uint64_t state = 0x4d6174636833ull;
+			for(int i = 0; i < Rows * Columns; ++i)
+			{
+				for(int j = 0; j < Types; ++j)
+				{
+					state += 0x9e3779b97f4a7c15ull;
+					uint64_t z = state;
+					z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+					z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+					keys[i][j] = z ^ (z >> 31);
+				}
+			}
+		}
+	};
+
+	static constexpr KeyTable TABLE = KeyTable();
+public:
+	//type is block texture (TID_BLOCK_1...) or -1 for empty cell
+	static uint64_t key(int x, int y, int type)
+	{
+		return (type == -1) ? 0 : TABLE.keys[y * Columns + x][type - TID_BLOCK_1];
+	}
+
+	//from scratch, for positions that aren't maintained incrementally
+	static uint64_t hash(const PackedTypeGrid<Rows, Columns, Types> &grid)
+	{
+		uint64_t h = 0;
+		for(int i = 0; i < Rows; ++i)
+		{
+			for(int j = 0; j < Columns; ++j)
+			{
+				h ^= key(j, i, grid.get(j, i));
+			}
+		}
+		return h;
+	}
+};
+
+template<int Rows, int Columns, int Types>
+constexpr typename BasicZobrist<Rows, Columns, Types>::KeyTable BasicZobrist<Rows, Columns, Types>::TABLE;
+
+typedef BasicZobrist<NUM_BLOCK_ROWS, NUM_BLOCK_COLUMNS, NUM_BLOCK_TYPES> Zobrist;
+
+#endif
@@ -1,17 +1,67 @@
 #include <iostream>
+#include <fstream>
+#include <cstring>
 #include <SDL.h>
 #include <math.h>
 
 #include "Game.h"
+#include "SessionRecord.h"
+#include "Profiler.h"
 
 int main(int argc, char **argv)
 {
+	//--record <file> writes the session for match3-batch --replay,
+	//--profile shows frame phase timings, --trace <file> writes them
+	//in chrome trace_event format on exit
+	const char *recordPath = nullptr;
+	const char *tracePath = nullptr;
+	bool profile = false;
+	for(int i = 1; i < argc; ++i)
+	{
+		if(!strcmp(argv[i], "--record") && i + 1 < argc)
+		{
+			recordPath = argv[++i];
+		}
+		else if(!strcmp(argv[i], "--trace") && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if(!strcmp(argv[i], "--profile"))
+		{
+			profile = true;
+		}
+	}
+	Profiler::setEnabled(profile || tracePath);
+
 	try
 	{
 		SDLRenderer ren;
-		Game game(ren);
+		SDLClock clock;
+		SDLEventSource events;
+		Game game(ren, clock, events);
+
+		std::ofstream recordFile;
+		std::unique_ptr<SessionRecorder> recorder;
+		if(recordPath)
+		{
+			recordFile.open(recordPath, std::ios::binary | std::ios::trunc);
+			if(!recordFile)
+			{
+				std::cout << "can't open " << recordPath << std::endl;
+				return 1;
+			}
+			recorder.reset(new SessionRecorder(recordFile));
+			game.setRecorder(recorder.get());
+		}
+		game.setProfilerOverlay(profile);
 
 		game.runEventLoop();
+
+		if(tracePath)
+		{
+			std::ofstream traceFile(tracePath);
+			Profiler::writeChromeTrace(traceFile);
+		}
 	}
 	catch(RendererException &re)
 	{
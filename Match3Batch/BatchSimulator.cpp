@@ -0,0 +1,159 @@
+#include "GameImpl.h"
+#include "GameSession.h"
+#include "BatchSimulator.h"
+#include "MovePolicy.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+BatchOptions::BatchOptions() :
+games(1000),
+threads(0),
+seed(1),
+frameTime(16),
+moveDelay(250)
+{
+}
+
+Distribution::Distribution() :
+mean(0),
+min(0),
+p10(0),
+p50(0),
+p90(0),
+p99(0),
+max(0)
+{
+}
+
+void Distribution::calculate(std::vector<int> &values)
+{
+	if(values.empty())
+	{
+		return;
+	}
+	std::sort(values.begin(), values.end());
+	double sum = 0;
+	for(int v : values)
+	{
+		sum += v;
+	}
+	const int n = (int)values.size();
+	auto percentile = [&] (int p) -> int {
+		return values[(long long)(n - 1) * p / 100];
+	};
+	mean = sum / n;
+	min = values.front();
+	p10 = percentile(10);
+	p50 = percentile(50);
+	p90 = percentile(90);
+	p99 = percentile(99);
+	max = values.back();
+}
+
+BatchSimulator::BatchSimulator(const BatchOptions &o, const MovePolicy &p) :
+options(o),
+policy(p)
+{
+}
+
+//center of board cell in screen coordinates
+static void cellCenter(int x, int y, int &screenX, int &screenY)
+{
+	screenX = BOARD_POS_X + x * BLOCK_SIZE_X + BLOCK_SIZE_X / 2;
+	screenY = BOARD_POS_Y + y * BLOCK_SIZE_Y + BLOCK_SIZE_Y / 2;
+}
+
+GameResult BatchSimulator::playGame(Renderer &renderer, std::mt19937 &rng, int game) const
+{
+	//board and policy streams of every game are independent of the worker running it
+	std::seed_seq boardSeed = { options.seed, (unsigned int)game, 0u };
+	std::seed_seq policySeed = { options.seed, (unsigned int)game, 1u };
+	unsigned int boardSeedValue;
+	boardSeed.generate(&boardSeedValue, &boardSeedValue + 1);
+	rng.seed(policySeed);
+
+	GameSession session(renderer, boardSeedValue);
+	session.start();
+
+	unsigned int nextMoveTime = session.getTime() + options.moveDelay;
+	while(session.isGameStarted())
+	{
+		const Board &board = session.getBoard();
+		if(board.isSettled() && session.getTime() >= nextMoveTime)
+		{
+			Move move;
+			if(policy.chooseMove(board, rng, move))
+			{
+				//drag from source to destination block, as a player would
+				InputEvent e;
+				e.type = InputEventType::MouseDown;
+				cellCenter(move.srcX, move.srcY, e.x, e.y);
+				session.applyInput(e);
+				e.type = InputEventType::MouseUp;
+				cellCenter(move.dstX, move.dstY, e.x, e.y);
+				session.applyInput(e);
+			}
+			nextMoveTime = session.getTime() + options.moveDelay;
+		}
+		session.step(options.frameTime);
+	}
+
+	GameResult result;
+	result.score = session.getScore();
+	result.stats = session.getStats();
+	return result;
+}
+
+BatchReport BatchSimulator::run(std::vector<GameResult> &results) const
+{
+	WorkStealingPool pool(options.threads);
+
+	//per worker state, created up front so workers never allocate shared data
+	struct WorkerState
+	{
+		NullRenderer		renderer;
+		std::mt19937		rng;
+	};
+	std::vector<std::unique_ptr<WorkerState>> workers;
+	for(int i = 0; i < pool.getNumWorkers(); ++i)
+	{
+		workers.push_back(std::unique_ptr<WorkerState>(new WorkerState));
+	}
+
+	results.resize(options.games);
+	auto startTime = std::chrono::steady_clock::now();
+	pool.run(options.games, [&] (int game, int worker) {
+		WorkerState &state = *workers[worker];
+		results[game] = playGame(state.renderer, state.rng, game);
+	});
+	auto stopTime = std::chrono::steady_clock::now();
+
+	BatchReport report;
+	report.games = options.games;
+	report.threads = pool.getNumWorkers();
+	report.seconds = std::chrono::duration<double>(stopTime - startTime).count();
+
+	std::vector<int> scores, kills, swaps;
+	for(int i = 0; i <= MAX_CASCADE_DEPTH; ++i)
+	{
+		report.cascades[i] = 0;
+	}
+	report.reshuffles = 0;
+	for(const GameResult &r : results)
+	{
+		scores.push_back(r.score);
+		kills.push_back(r.stats.kills);
+		swaps.push_back(r.stats.swaps);
+		for(int i = 0; i <= MAX_CASCADE_DEPTH; ++i)
+		{
+			report.cascades[i] += r.stats.cascades[i];
+		}
+		report.reshuffles += r.stats.reshuffles;
+	}
+	report.score.calculate(scores);
+	report.kills.calculate(kills);
+	report.swaps.calculate(swaps);
+	return report;
+}
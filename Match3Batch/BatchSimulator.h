@@ -0,0 +1,73 @@
+#ifndef _BATCH_SIMULATOR_H_
+#define _BATCH_SIMULATOR_H_
+
+#include <vector>
+
+class MovePolicy;
+
+struct BatchOptions
+{
+	int						games;
+	//0 means one per hardware thread
+	int						threads;
+	unsigned int			seed;
+	//simulation step, game time advances by this much every frame
+	unsigned int			frameTime;
+	//time simulated player waits on a settled board before trying a move
+	unsigned int			moveDelay;
+
+	BatchOptions();
+};
+
+struct GameResult
+{
+	int						score;
+	GameStats				stats;
+};
+
+//summary of values over all games
+struct Distribution
+{
+	double					mean;
+	int						min;
+	int						p10;
+	int						p50;
+	int						p90;
+	int						p99;
+	int						max;
+
+	Distribution();
+	//values are sorted in place
+	void calculate(std::vector<int> &values);
+};
+
+struct BatchReport
+{
+	int						games;
+	int						threads;
+	double					seconds;
+
+	Distribution			score;
+	Distribution			kills;
+	Distribution			swaps;
+	//number of cascades of every depth over all games
+	long long				cascades[MAX_CASCADE_DEPTH + 1];
+	long long				reshuffles;
+};
+
+//plays complete games headlessly on all cores; game i is seeded from
+//(seed, i) only, so results don't depend on thread count or scheduling
+class BatchSimulator
+{
+	const BatchOptions		&options;
+	const MovePolicy		&policy;
+public:
+	BatchSimulator(const BatchOptions &o, const MovePolicy &p);
+
+	//play a single game from start to timeout
+	GameResult playGame(Renderer &renderer, std::mt19937 &rng, int game) const;
+	//results are indexed by game
+	BatchReport run(std::vector<GameResult> &results) const;
+};
+
+#endif
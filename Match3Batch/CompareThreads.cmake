@@ -0,0 +1,27 @@
+# runs the same batch with one and with four threads and fails unless both
+# print the same results; only the wall time on the first line and the
+# bot's nodes per second are allowed to differ
+#
+#     cmake -DBATCH=path/to/match3-batch -P CompareThreads.cmake
+
+if(NOT BATCH)
+	message(FATAL_ERROR "BATCH must be the path of match3-batch")
+endif()
+
+set(ARGS --games 12 --policy bot --seed 3)
+foreach(THREADS 1 4)
+	execute_process(COMMAND "${BATCH}" ${ARGS} --threads ${THREADS}
+		OUTPUT_VARIABLE OUTPUT
+		RESULT_VARIABLE RESULT)
+	if(NOT RESULT EQUAL 0)
+		message(FATAL_ERROR "match3-batch --threads ${THREADS} failed: ${RESULT}")
+	endif()
+	string(REGEX REPLACE "^[^\n]*\n" "" OUTPUT "${OUTPUT}")
+	string(REGEX REPLACE ", [0-9]+ nodes/s per thread" "" OUTPUT "${OUTPUT}")
+	set(OUTPUT_${THREADS} "${OUTPUT}")
+endforeach()
+
+if(NOT OUTPUT_1 STREQUAL OUTPUT_4)
+	message(FATAL_ERROR "results differ between thread counts\n"
+		"--threads 1:\n${OUTPUT_1}\n--threads 4:\n${OUTPUT_4}")
+endif()
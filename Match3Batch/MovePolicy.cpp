@@ -0,0 +1,90 @@
+#include "GameImpl.h"
+#include "MovePolicy.h"
+
+bool RandomPolicy::chooseMove(const Board &board, std::mt19937 &rng, Move &move) const
+{
+	std::uniform_int_distribution<int> column(0, NUM_BLOCK_COLUMNS - 1);
+	std::uniform_int_distribution<int> row(0, NUM_BLOCK_ROWS - 1);
+	std::uniform_int_distribution<int> direction(0, 3);
+	move.srcX = column(rng);
+	move.srcY = row(rng);
+	int d = direction(rng);
+	move.dstX = move.srcX + (d == 0) - (d == 1);
+	move.dstY = move.srcY + (d == 2) - (d == 3);
+	return move.dstX >= 0 && move.dstX < NUM_BLOCK_COLUMNS &&
+		move.dstY >= 0 && move.dstY < NUM_BLOCK_ROWS;
+}
+
+bool RandomKillPolicy::chooseMove(const Board &board, std::mt19937 &rng, Move &move) const
+{
+	Move moves[MoveGenerator::MAX_MOVES];
+	int count = MoveGenerator(board.bitBoard).getMoves(moves);
+	if(!count)
+	{
+		return false;
+	}
+	move = moves[std::uniform_int_distribution<int>(0, count - 1)(rng)];
+	return true;
+}
+
+bool FirstKillPolicy::chooseMove(const Board &board, std::mt19937 &rng, Move &move) const
+{
+	return board.findHint(move);
+}
+
+BotPolicy::BotPolicy(const BotOptions &options) :
+bot(options),
+nodes(0),
+microseconds(0),
+moves(0)
+{
+}
+
+bool BotPolicy::chooseMove(const Board &board, std::mt19937 &rng, Move &move) const
+{
+	BotStats stats;
+	if(!bot.findMove(board.blockTypes, board.hash, (unsigned int)rng(), move, &stats))
+	{
+		return false;
+	}
+	nodes += stats.nodes;
+	microseconds += (long long)(stats.seconds * 1e6);
+	moves++;
+	return true;
+}
+
+void BotPolicy::printStats(std::ostream &out) const
+{
+	const double seconds = microseconds.load() / 1e6;
+	out << "bot: " << moves.load() << " moves, " << nodes.load() << " nodes, "
+		<< (long long)(seconds > 0 ? nodes.load() / seconds : 0) << " nodes/s per thread" << std::endl;
+}
+
+std::unique_ptr<MovePolicy> createMovePolicy(const std::string &name)
+{
+	if(name == "random")
+	{
+		return std::unique_ptr<MovePolicy>(new RandomPolicy);
+	}
+	if(name == "random-kill")
+	{
+		return std::unique_ptr<MovePolicy>(new RandomKillPolicy);
+	}
+	if(name == "first-kill")
+	{
+		return std::unique_ptr<MovePolicy>(new FirstKillPolicy);
+	}
+	if(name == "bot")
+	{
+		BotOptions options;
+		options.threads = 1;
+		//nodes only, a wall clock deadline would make results depend on
+		//machine load and --threads
+		options.timeBudget = 0;
+		options.nodeBudget = 2000;
+		//table would be shared by games running in parallel
+		options.tableSize = 0;
+		return std::unique_ptr<MovePolicy>(new BotPolicy(options));
+	}
+	return nullptr;
+}
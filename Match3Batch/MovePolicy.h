@@ -0,0 +1,63 @@
+#ifndef _MOVE_POLICY_H_
+#define _MOVE_POLICY_H_
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+
+//decides which swap a simulated player tries next; policies are shared
+//between workers, so all per game state comes in through arguments
+class MovePolicy
+{
+public:
+	//return false if policy doesn't want to move now
+	virtual bool chooseMove(const Board &board, std::mt19937 &rng, Move &move) const = 0;
+	//summary printed after the batch
+	virtual void printStats(std::ostream &out) const
+	{
+	}
+};
+
+//swaps random neighbors, most of them don't kill anything and are rejected
+class RandomPolicy : public MovePolicy
+{
+public:
+	bool chooseMove(const Board &board, std::mt19937 &rng, Move &move) const;
+};
+
+//picks uniformly among all killing swaps
+class RandomKillPolicy : public MovePolicy
+{
+public:
+	bool chooseMove(const Board &board, std::mt19937 &rng, Move &move) const;
+};
+
+//always plays the first killing swap in board order, ignores rng
+class FirstKillPolicy : public MovePolicy
+{
+public:
+	bool chooseMove(const Board &board, std::mt19937 &rng, Move &move) const;
+};
+
+//searches every move with the expectimax bot; single threaded, limited
+//by nodes instead of time and without transposition table, so batch
+//results stay reproducible
+class BotPolicy : public MovePolicy
+{
+	Bot								bot;
+	mutable std::atomic<long long>	nodes;
+	mutable std::atomic<long long>	microseconds;
+	mutable std::atomic<long long>	moves;
+public:
+	BotPolicy(const BotOptions &options);
+
+	bool chooseMove(const Board &board, std::mt19937 &rng, Move &move) const;
+	void printStats(std::ostream &out) const;
+};
+
+//"random", "random-kill", "first-kill" or "bot", null for unknown names
+std::unique_ptr<MovePolicy> createMovePolicy(const std::string &name);
+
+#endif
@@ -0,0 +1,115 @@
+#include "WorkStealingPool.h"
+
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int workers) :
+numWorkers(workers)
+{
+	if(numWorkers <= 0)
+	{
+		numWorkers = (int)std::thread::hardware_concurrency();
+	}
+	if(numWorkers <= 0)
+	{
+		numWorkers = 1;
+	}
+	for(int i = 0; i < numWorkers; ++i)
+	{
+		ranges.push_back(std::unique_ptr<WorkRange>(new WorkRange));
+	}
+}
+
+int WorkStealingPool::getNumWorkers() const
+{
+	return numWorkers;
+}
+
+bool WorkStealingPool::popLocal(int worker, int &task)
+{
+	WorkRange &range = *ranges[worker];
+	std::lock_guard<std::mutex> guard(range.lock);
+	if(range.begin >= range.end)
+	{
+		return false;
+	}
+	task = range.begin++;
+	return true;
+}
+
+bool WorkStealingPool::steal(int worker, unsigned int &victimSeed)
+{
+	//start at a random victim so thieves don't all hit the same worker
+	victimSeed ^= victimSeed << 13;
+	victimSeed ^= victimSeed >> 17;
+	victimSeed ^= victimSeed << 5;
+	const int first = (int)(victimSeed % (unsigned int)numWorkers);
+	for(int i = 0; i < numWorkers; ++i)
+	{
+		int victim = (first + i) % numWorkers;
+		if(victim == worker)
+		{
+			continue;
+		}
+		int begin, end;
+		{
+			WorkRange &range = *ranges[victim];
+			std::lock_guard<std::mutex> guard(range.lock);
+			int remaining = range.end - range.begin;
+			if(remaining <= 0)
+			{
+				continue;
+			}
+			//victim keeps the lower half and continues with it
+			begin = range.end - (remaining + 1) / 2;
+			end = range.end;
+			range.end = begin;
+		}
+		WorkRange &own = *ranges[worker];
+		std::lock_guard<std::mutex> guard(own.lock);
+		own.begin = begin;
+		own.end = end;
+		return true;
+	}
+	return false;
+}
+
+void WorkStealingPool::workerLoop(int worker, const std::function<void (int task, int worker)> &f)
+{
+	unsigned int victimSeed = 2463534242u + (unsigned int)worker * 0x9e3779b9u;
+	for(;;)
+	{
+		int task;
+		if(popLocal(worker, task))
+		{
+			f(task, worker);
+			continue;
+		}
+		//tasks never spawn new tasks, so once nothing can be stolen we are done
+		if(!steal(worker, victimSeed))
+		{
+			return;
+		}
+	}
+}
+
+void WorkStealingPool::run(int count, const std::function<void (int task, int worker)> &f)
+{
+	for(int i = 0; i < numWorkers; ++i)
+	{
+		ranges[i]->begin = (int)((long long)count * i / numWorkers);
+		ranges[i]->end = (int)((long long)count * (i + 1) / numWorkers);
+	}
+
+	std::vector<std::thread> threads;
+	for(int i = 1; i < numWorkers; ++i)
+	{
+		threads.push_back(std::thread([this, i, &f] () {
+			workerLoop(i, f);
+		}));
+	}
+	workerLoop(0, f);
+	for(auto &t : threads)
+	{
+		t.join();
+	}
+}
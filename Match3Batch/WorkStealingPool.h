@@ -0,0 +1,39 @@
+#ifndef _WORK_STEALING_POOL_H_
+#define _WORK_STEALING_POOL_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//runs tasks 0...count - 1 on a fixed number of threads; every worker starts
+//with a contiguous slice of task indices and, once its slice is empty, steals
+//the upper half of a random victim's remaining slice
+class WorkStealingPool
+{
+	struct WorkRange
+	{
+		std::mutex				lock;
+		int						begin;
+		int						end;
+		//keeps ranges of different workers on separate cache lines
+		char					padding[64];
+	};
+
+	int										numWorkers;
+	std::vector<std::unique_ptr<WorkRange>>	ranges;
+
+	bool popLocal(int worker, int &task);
+	bool steal(int worker, unsigned int &victimSeed);
+	void workerLoop(int worker, const std::function<void (int task, int worker)> &f);
+public:
+	//0 means one worker per hardware thread
+	WorkStealingPool(int workers = 0);
+
+	int getNumWorkers() const;
+	//blocks until all tasks are done, f may be called concurrently
+	//with different task and worker indices
+	void run(int count, const std::function<void (int task, int worker)> &f);
+};
+
+#endif
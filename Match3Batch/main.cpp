@@ -0,0 +1,146 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+#include "GameImpl.h"
+#include "GameSession.h"
+#include "BatchSimulator.h"
+#include "MovePolicy.h"
+
+static void printUsage()
+{
+	std::cout << "usage: match3-batch [--games N] [--threads N] [--seed N] [--policy NAME]"
+		" [--frame-time MS] [--move-delay MS]" << std::endl;
+	std::cout << "       match3-batch --replay FILE" << std::endl;
+	std::cout << "policies: random, random-kill, first-kill, bot" << std::endl;
+}
+
+//play a record written by match3 --record
+static int replay(const char *path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if(!file)
+	{
+		std::cout << "can't open " << path << std::endl;
+		return 1;
+	}
+	try
+	{
+		NullRenderer renderer;
+		SessionPlayer player(renderer, file);
+		auto start = std::chrono::steady_clock::now();
+		player.playAll();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const GameSession &session = player.getSession();
+		const GameStats &stats = session.getStats();
+		std::cout << "seed " << player.getSeed() << ", " << player.getTime() / 1000.0 << " s of play replayed in "
+			<< std::fixed << std::setprecision(3) << seconds << " s, " << player.getCheckpointCount()
+			<< " checkpoints" << std::endl;
+		std::cout << "score " << session.getScore() << ", swaps " << stats.swaps << ", kills " << stats.kills
+			<< ", reshuffles " << stats.reshuffles << std::endl;
+	}
+	catch(ReplayException *e)
+	{
+		std::cout << path << ": " << e->error << std::endl;
+		delete e;
+		return 1;
+	}
+	return 0;
+}
+
+static void printDistribution(const char *name, const Distribution &d)
+{
+	std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(1)
+		<< " mean " << d.mean
+		<< " min " << d.min
+		<< " p10 " << d.p10
+		<< " p50 " << d.p50
+		<< " p90 " << d.p90
+		<< " p99 " << d.p99
+		<< " max " << d.max << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	BatchOptions options;
+	std::string policyName = "random-kill";
+	const char *replayPath = nullptr;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+		if(!strcmp(argv[i], "--replay") && hasValue)
+		{
+			replayPath = argv[++i];
+		}
+		else if(!strcmp(argv[i], "--games") && hasValue)
+		{
+			options.games = atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--threads") && hasValue)
+		{
+			options.threads = atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--seed") && hasValue)
+		{
+			options.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		}
+		else if(!strcmp(argv[i], "--policy") && hasValue)
+		{
+			policyName = argv[++i];
+		}
+		else if(!strcmp(argv[i], "--frame-time") && hasValue)
+		{
+			options.frameTime = (unsigned int)atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--move-delay") && hasValue)
+		{
+			options.moveDelay = (unsigned int)atoi(argv[++i]);
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if(replayPath)
+	{
+		return replay(replayPath);
+	}
+
+	std::unique_ptr<MovePolicy> policy = createMovePolicy(policyName);
+	if(!policy || options.games <= 0 || options.frameTime == 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	BatchSimulator simulator(options, *policy);
+	std::vector<GameResult> results;
+	BatchReport report = simulator.run(results);
+
+	std::cout << report.games << " games, policy " << policyName << ", seed " << options.seed
+		<< ", " << report.threads << " threads, " << std::fixed << std::setprecision(2)
+		<< report.seconds << " s (" << report.games / report.seconds << " games/s)" << std::endl;
+	printDistribution("score", report.score);
+	printDistribution("kills", report.kills);
+	printDistribution("swaps", report.swaps);
+	std::cout << "cascade depth:";
+	for(int i = 1; i <= MAX_CASCADE_DEPTH; ++i)
+	{
+		if(report.cascades[i])
+		{
+			std::cout << " " << i << (i == MAX_CASCADE_DEPTH ? "+" : "") << ":" << report.cascades[i];
+		}
+	}
+	std::cout << std::endl;
+	std::cout << "reshuffles: " << report.reshuffles << std::endl;
+	policy->printStats(std::cout);
+
+	return 0;
+}
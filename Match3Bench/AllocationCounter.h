@@ -0,0 +1,16 @@
+#ifndef _ALLOCATION_COUNTER_H_
+#define _ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+
+//heap traffic since program start, counted by replacement global
+//operator new/delete linked into the benchmark binary
+struct AllocationCount
+{
+	uint64_t				allocations;
+	uint64_t				bytes;
+};
+
+AllocationCount getAllocationCount();
+
+#endif
@@ -0,0 +1,125 @@
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+
+BenchmarkOptions::BenchmarkOptions() :
+minTime(200)
+{
+}
+
+//time and heap traffic of a number of passes
+struct PassCost
+{
+	double					seconds;
+	AllocationCount			heap;
+};
+
+static PassCost runPasses(long long passes, int size, const Benchmark::Step &first, const Benchmark::Step &second)
+{
+	AllocationCount heapBefore = getAllocationCount();
+	auto startTime = std::chrono::steady_clock::now();
+	for(long long pass = 0; pass < passes; ++pass)
+	{
+		for(int i = 0; i < size; ++i)
+		{
+			first(i);
+			if(second)
+			{
+				second(i);
+			}
+		}
+	}
+	auto stopTime = std::chrono::steady_clock::now();
+	AllocationCount heapAfter = getAllocationCount();
+
+	PassCost cost;
+	cost.seconds = std::chrono::duration<double>(stopTime - startTime).count();
+	cost.heap.allocations = heapAfter.allocations - heapBefore.allocations;
+	cost.heap.bytes = heapAfter.bytes - heapBefore.bytes;
+	return cost;
+}
+
+Benchmark::Benchmark(const BenchmarkOptions &o) :
+options(o)
+{
+}
+
+bool Benchmark::isSelected(const std::string &kernel) const
+{
+	return kernel.find(options.filter) != std::string::npos;
+}
+
+void Benchmark::measure(const std::string &kernel, const std::string &corpus, int size,
+	const Step &kernelStep, const Step &setup)
+{
+	if(!isSelected(kernel) || size <= 0)
+	{
+		return;
+	}
+	const Step &first = setup ? setup : kernelStep;
+	const Step second = setup ? kernelStep : Step();
+
+	//warm up caches and lazily initialized tables, then double the
+	//number of passes until a run is long enough
+	runPasses(1, size, first, second);
+	long long passes = 1;
+	PassCost cost = runPasses(passes, size, first, second);
+	while(cost.seconds * 1000.0 < options.minTime)
+	{
+		passes *= 2;
+		cost = runPasses(passes, size, first, second);
+	}
+	if(setup)
+	{
+		PassCost setupCost = runPasses(passes, size, setup, Step());
+		cost.seconds = std::max(0.0, cost.seconds - setupCost.seconds);
+		cost.heap.allocations -= std::min(cost.heap.allocations, setupCost.heap.allocations);
+		cost.heap.bytes -= std::min(cost.heap.bytes, setupCost.heap.bytes);
+	}
+
+	BenchmarkResult result;
+	result.kernel = kernel;
+	result.corpus = corpus;
+	result.calls = passes * size;
+	result.nsPerBoard = cost.seconds * 1e9 / result.calls;
+	result.allocationsPerCall = (double)cost.heap.allocations / result.calls;
+	result.bytesPerCall = (double)cost.heap.bytes / result.calls;
+	results.push_back(result);
+}
+
+const std::vector<BenchmarkResult> &Benchmark::getResults() const
+{
+	return results;
+}
+
+void Benchmark::printTable(std::ostream &out) const
+{
+	out << std::left << std::setw(22) << "kernel" << std::setw(14) << "corpus"
+		<< std::right << std::setw(12) << "calls" << std::setw(14) << "ns/board"
+		<< std::setw(14) << "allocs/call" << std::setw(14) << "bytes/call" << std::endl;
+	for(const BenchmarkResult &r : results)
+	{
+		out << std::left << std::setw(22) << r.kernel << std::setw(14) << r.corpus
+			<< std::right << std::setw(12) << r.calls << std::fixed << std::setprecision(1)
+			<< std::setw(14) << r.nsPerBoard << std::setprecision(2)
+			<< std::setw(14) << r.allocationsPerCall << std::setw(14) << r.bytesPerCall << std::endl;
+	}
+}
+
+void Benchmark::printJson(std::ostream &out) const
+{
+	out << "{\"benchmarks\": [";
+	for(size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchmarkResult &r = results[i];
+		out << (i ? ",\n" : "\n") << "  {\"kernel\": \"" << r.kernel << "\", \"corpus\": \"" << r.corpus
+			<< "\", \"calls\": " << r.calls << std::fixed << std::setprecision(3)
+			<< ", \"ns_per_board\": " << r.nsPerBoard
+			<< ", \"allocations_per_call\": " << r.allocationsPerCall
+			<< ", \"bytes_per_call\": " << r.bytesPerCall << "}";
+	}
+	out << "\n]}" << std::endl;
+}
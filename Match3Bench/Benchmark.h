@@ -0,0 +1,52 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct BenchmarkOptions
+{
+	//every measurement repeats passes over its corpus for at least this long
+	unsigned int			minTime;
+	//only kernels whose name contains filter are measured
+	std::string				filter;
+
+	BenchmarkOptions();
+};
+
+struct BenchmarkResult
+{
+	std::string				kernel;
+	std::string				corpus;
+	long long				calls;
+	//one call processes one board
+	double					nsPerBoard;
+	double					allocationsPerCall;
+	double					bytesPerCall;
+};
+
+//times kernels over corpus indices 0...size - 1 in repeated passes
+class Benchmark
+{
+	BenchmarkOptions		options;
+	std::vector<BenchmarkResult>	results;
+public:
+	typedef std::function<void (int)>	Step;
+
+	Benchmark(const BenchmarkOptions &o);
+
+	bool isSelected(const std::string &kernel) const;
+	//setup runs before every call of kernel and is not part of the result:
+	//passes of setup alone are timed separately and subtracted
+	void measure(const std::string &kernel, const std::string &corpus, int size,
+		const Step &kernelStep, const Step &setup = Step());
+
+	const std::vector<BenchmarkResult> &getResults() const;
+	void printTable(std::ostream &out) const;
+	//one JSON document with all results, for regression tracking scripts
+	void printJson(std::ostream &out) const;
+};
+
+#endif
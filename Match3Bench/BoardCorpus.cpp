@@ -0,0 +1,86 @@
+#include "GameImpl.h"
+#include "BoardCorpus.h"
+
+//random board using only the first types block types, false if it has no move
+static bool createRandomBoard(BoardRng &rng, int types, Board::State &state, Move &move)
+{
+	BitBoard bitBoard;
+	state.types.clear();
+	for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
+	{
+		for(int j = 0; j < NUM_BLOCK_COLUMNS; ++j)
+		{
+			int type = TID_BLOCK_1 + (int)(rng() % types);
+			state.types.set(j, i, type);
+			bitBoard.setType(j, i, type);
+		}
+	}
+	return MoveGenerator(bitBoard).getHint(move);
+}
+
+static BoardCorpus createRandomTypesCorpus(const char *name, unsigned int seed, int size, int types)
+{
+	BoardCorpus corpus;
+	corpus.name = name;
+	BoardRng rng(seed);
+	Board::State state;
+	Move move;
+	while((int)corpus.boards.size() < size)
+	{
+		state.rng = BoardRng(rng());
+		if(createRandomBoard(rng, types, state, move))
+		{
+			corpus.boards.push_back(state);
+			corpus.moves.push_back(move);
+		}
+	}
+	return corpus;
+}
+
+BoardCorpus createRandomCorpus(unsigned int seed, int size)
+{
+	return createRandomTypesCorpus("random", seed, size, NUM_BLOCK_TYPES);
+}
+
+BoardCorpus createDenseMatchCorpus(unsigned int seed, int size)
+{
+	return createRandomTypesCorpus("dense-match", seed, size, 2);
+}
+
+BoardCorpus createDeepCascadeCorpus(unsigned int seed, int size)
+{
+	BoardCorpus corpus;
+	corpus.name = "deep-cascade";
+	BoardRng rng(seed);
+	BoardGenerator generator(rng);
+	Board::State state;
+	Move moves[MoveGenerator::MAX_MOVES];
+	CascadeResolver::Result result;
+	while((int)corpus.boards.size() < size)
+	{
+		generator.generate(state.types);
+		state.rng = BoardRng(rng());
+		const uint64_t hash = Zobrist::hash(state.types);
+
+		BitBoard bitBoard;
+		for(int i = 0; i < NUM_BLOCK_ROWS; ++i)
+		{
+			for(int j = 0; j < NUM_BLOCK_COLUMNS; ++j)
+			{
+				bitBoard.setType(j, i, state.types.get(j, i));
+			}
+		}
+		int moveCount = MoveGenerator(bitBoard).getMoves(moves);
+		for(int i = 0; i < moveCount; ++i)
+		{
+			BoardRng spawns = state.rng;
+			if(CascadeResolver::resolve(state.types, hash, moves[i], spawns, result) && result.depth >= MIN_CASCADE_DEPTH)
+			{
+				corpus.boards.push_back(state);
+				corpus.moves.push_back(moves[i]);
+				break;
+			}
+		}
+	}
+	return corpus;
+}
@@ -0,0 +1,26 @@
+#ifndef _BOARD_CORPUS_H_
+#define _BOARD_CORPUS_H_
+
+#include <string>
+#include <vector>
+
+//fixed seed set of positions kernels are measured on, the same seed
+//and size always give the same boards
+struct BoardCorpus
+{
+	std::string				name;
+	std::vector<Board::State>	boards;
+	//killing swap of every board
+	std::vector<Move>		moves;
+};
+
+const int MIN_CASCADE_DEPTH = 3;
+
+//uniformly random blocks, most boards have pending kills
+BoardCorpus createRandomCorpus(unsigned int seed, int size);
+//blocks of only two types, so most blocks belong to some run
+BoardCorpus createDenseMatchCorpus(unsigned int seed, int size);
+//generated boards without kills, every move cascades at least MIN_CASCADE_DEPTH times
+BoardCorpus createDeepCascadeCorpus(unsigned int seed, int size);
+
+#endif
@@ -0,0 +1,232 @@
+#include "GameImpl.h"
+#include "GameSession.h"
+#include "GameLoopBenchmark.h"
+#include "AllocationCounter.h"
+#include "SoftwareBlend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+GameLoopOptions::GameLoopOptions() :
+games(20),
+seed(1),
+frameTime(16),
+moveDelay(250),
+software(false)
+{
+}
+
+//window size of SDLRenderer
+static const int FRAME_WIDTH = 755;
+static const int FRAME_HEIGHT = 600;
+static const int GLYPH_WIDTH = 9;
+static const int GLYPH_HEIGHT = 16;
+
+//flat stand-ins for game textures and font, so software frames cost
+//about the same as real ones without loading any image files
+static void loadSyntheticImages(SoftwareRenderer &renderer)
+{
+	SoftwareImage background(FRAME_WIDTH, FRAME_HEIGHT);
+	for(int y = 0; y < FRAME_HEIGHT; ++y)
+	{
+		for(int x = 0; x < FRAME_WIDTH; ++x)
+		{
+			background.pixels[y * FRAME_WIDTH + x] = packRGBA((uint8_t)x, (uint8_t)y, 96, 255);
+		}
+	}
+	renderer.setTexture(TID_BACKGROUND, background);
+
+	//round gems with transparent corners
+	const int size = BLOCK_SIZE_X - 2;
+	const int radius = size / 2;
+	for(int tid = TID_BLOCK_1; tid < TID_LAST; ++tid)
+	{
+		SoftwareImage block(size, size);
+		for(int y = 0; y < size; ++y)
+		{
+			for(int x = 0; x < size; ++x)
+			{
+				const int dx = x - radius;
+				const int dy = y - radius;
+				const uint8_t alpha = dx * dx + dy * dy <= radius * radius ? 255 : 0;
+				block.pixels[y * size + x] = packRGBA((uint8_t)(tid * 48), (uint8_t)(x * 6), (uint8_t)(y * 6), alpha);
+			}
+		}
+		renderer.setTexture((TextureID)tid, block);
+	}
+
+	SoftwareImage glyph(GLYPH_WIDTH, GLYPH_HEIGHT);
+	for(int i = 0; i < GLYPH_WIDTH * GLYPH_HEIGHT; ++i)
+	{
+		glyph.pixels[i] = packRGBA(255, 255, 255, (uint8_t)(i * 37));
+	}
+	for(int c = ' '; c <= '~'; ++c)
+	{
+		renderer.setGlyph((char)c, glyph, GLYPH_WIDTH + 1);
+	}
+}
+
+GameLoopBenchmark::GameLoopBenchmark(const GameLoopOptions &o) :
+options(o)
+{
+	frameCosts.reserve(MAX_RECORDED_FRAMES);
+}
+
+//center of board cell in screen coordinates
+static void cellCenter(int x, int y, int &screenX, int &screenY)
+{
+	screenX = BOARD_POS_X + x * BLOCK_SIZE_X + BLOCK_SIZE_X / 2;
+	screenY = BOARD_POS_Y + y * BLOCK_SIZE_Y + BLOCK_SIZE_Y / 2;
+}
+
+static uint32_t elapsedNs(std::chrono::steady_clock::time_point start)
+{
+	return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+void GameLoopBenchmark::playSyntheticGame(Renderer &renderer, int game)
+{
+	//script of every game depends only on seed and game index
+	BoardRng rng(((uint64_t)options.seed << 32) | (unsigned int)game);
+	GameSession session(renderer, rng());
+	session.start();
+
+	Move moves[MoveGenerator::MAX_MOVES];
+	unsigned int nextMoveTime = session.getTime() + options.moveDelay;
+	InputEvent e;
+	while(session.isGameStarted())
+	{
+		auto frameStart = std::chrono::steady_clock::now();
+
+		//pointer hovers over a random block every frame, as mouse motion
+		//marks blocks under it
+		e.type = InputEventType::MouseMotion;
+		cellCenter(rng() % NUM_BLOCK_COLUMNS, rng() % NUM_BLOCK_ROWS, e.x, e.y);
+		session.applyInput(e);
+
+		const Board &board = session.getBoard();
+		if(board.isSettled() && session.getTime() >= nextMoveTime)
+		{
+			int moveCount = MoveGenerator(board.bitBoard).getMoves(moves);
+			if(moveCount)
+			{
+				const Move &move = moves[rng() % moveCount];
+				e.type = InputEventType::MouseDown;
+				cellCenter(move.srcX, move.srcY, e.x, e.y);
+				session.applyInput(e);
+				e.type = InputEventType::MouseUp;
+				cellCenter(move.dstX, move.dstY, e.x, e.y);
+				session.applyInput(e);
+			}
+			nextMoveTime = session.getTime() + options.moveDelay;
+		}
+
+		session.step(options.frameTime);
+		session.render();
+		frameCosts.push_back(elapsedNs(frameStart));
+	}
+}
+
+unsigned int GameLoopBenchmark::playRecord(Renderer &renderer)
+{
+	std::ifstream file(options.replayPath, std::ios::binary);
+	if(!file)
+	{
+		throw new ReplayException("can't open " + options.replayPath);
+	}
+	SessionPlayer player(renderer, file);
+	for(;;)
+	{
+		auto frameStart = std::chrono::steady_clock::now();
+		if(!player.playFrame())
+		{
+			break;
+		}
+		player.getSession().render();
+		frameCosts.push_back(elapsedNs(frameStart));
+	}
+	return player.getTime();
+}
+
+GameLoopReport GameLoopBenchmark::run()
+{
+	NullRenderer nullRenderer;
+	SoftwareRenderer softwareRenderer(FRAME_WIDTH, FRAME_HEIGHT);
+	loadSyntheticImages(softwareRenderer);
+	Renderer &renderer = options.software ? (Renderer&)softwareRenderer : (Renderer&)nullRenderer;
+	GameLoopReport report;
+	frameCosts.clear();
+
+	const bool replay = !options.replayPath.empty();
+	report.games = replay ? 1 : options.games;
+	report.gameSeconds = 0;
+	AllocationCount heapBefore = getAllocationCount();
+	auto startTime = std::chrono::steady_clock::now();
+	if(replay)
+	{
+		report.gameSeconds = playRecord(renderer) / 1000.0;
+	}
+	else
+	{
+		for(int i = 0; i < options.games; ++i)
+		{
+			size_t firstFrame = frameCosts.size();
+			playSyntheticGame(renderer, i);
+			report.gameSeconds += (frameCosts.size() - firstFrame) * options.frameTime / 1000.0;
+		}
+	}
+	auto stopTime = std::chrono::steady_clock::now();
+	AllocationCount heapAfter = getAllocationCount();
+
+	report.frames = (long long)frameCosts.size();
+	report.seconds = std::chrono::duration<double>(stopTime - startTime).count();
+	report.framesPerSecond = report.seconds > 0 ? report.frames / report.seconds : 0;
+	report.allocationsPerGame = (double)(heapAfter.allocations - heapBefore.allocations) / report.games;
+	report.bytesPerGame = (double)(heapAfter.bytes - heapBefore.bytes) / report.games;
+	report.sessionsPerCore = report.seconds > 0 ? report.gameSeconds / report.seconds : 0;
+
+	report.p50FrameNs = report.p99FrameNs = report.maxFrameNs = 0;
+	if(!frameCosts.empty())
+	{
+		auto percentile = [&] (int p) -> double {
+			auto nth = frameCosts.begin() + (frameCosts.size() - 1) * p / 100;
+			std::nth_element(frameCosts.begin(), nth, frameCosts.end());
+			return *nth;
+		};
+		report.p50FrameNs = percentile(50);
+		report.p99FrameNs = percentile(99);
+		report.maxFrameNs = percentile(100);
+	}
+	return report;
+}
+
+void GameLoopBenchmark::printReport(std::ostream &out, const GameLoopReport &report)
+{
+	out << report.games << " games, " << report.frames << " frames, " << std::fixed << std::setprecision(2)
+		<< report.gameSeconds << " s of play in " << report.seconds << " s" << std::endl;
+	out << std::setprecision(0) << report.framesPerSecond << " frames/s, frame p50 " << report.p50FrameNs
+		<< " ns, p99 " << report.p99FrameNs << " ns, max " << report.maxFrameNs << " ns" << std::endl;
+	out << "heap per game: " << report.allocationsPerGame << " allocations, " << report.bytesPerGame
+		<< " bytes" << std::endl;
+	out << std::setprecision(1) << report.sessionsPerCore << " real time sessions per core" << std::endl;
+}
+
+void GameLoopBenchmark::printJson(std::ostream &out, const GameLoopReport &report)
+{
+	out << std::fixed << std::setprecision(3)
+		<< "{\"game_loop\": {\"games\": " << report.games
+		<< ", \"frames\": " << report.frames
+		<< ", \"seconds\": " << report.seconds
+		<< ", \"game_seconds\": " << report.gameSeconds
+		<< ", \"frames_per_second\": " << report.framesPerSecond
+		<< ", \"p50_frame_ns\": " << report.p50FrameNs
+		<< ", \"p99_frame_ns\": " << report.p99FrameNs
+		<< ", \"max_frame_ns\": " << report.maxFrameNs
+		<< ", \"allocations_per_game\": " << report.allocationsPerGame
+		<< ", \"bytes_per_game\": " << report.bytesPerGame
+		<< ", \"sessions_per_core\": " << report.sessionsPerCore << "}}" << std::endl;
+}
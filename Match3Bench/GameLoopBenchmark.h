@@ -0,0 +1,65 @@
+#ifndef _GAME_LOOP_BENCHMARK_H_
+#define _GAME_LOOP_BENCHMARK_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct GameLoopOptions
+{
+	int						games;
+	unsigned int			seed;
+	//game time advanced by every frame of synthetic games
+	unsigned int			frameTime;
+	//time synthetic player waits on a settled board before a move
+	unsigned int			moveDelay;
+	//session record played instead of synthetic games when not empty
+	std::string				replayPath;
+	//frames rasterized by SoftwareRenderer instead of dropped by NullRenderer
+	bool					software;
+
+	GameLoopOptions();
+};
+
+struct GameLoopReport
+{
+	int						games;
+	long long				frames;
+	//wall time of all frames and game time they covered
+	double					seconds;
+	double					gameSeconds;
+	double					framesPerSecond;
+	//cost of one frame: input, simulate and render
+	double					p50FrameNs;
+	double					p99FrameNs;
+	double					maxFrameNs;
+	double					allocationsPerGame;
+	double					bytesPerGame;
+	//real time sessions a single core keeps up with
+	double					sessionsPerCore;
+};
+
+//whole sessions through GameSession (input processing, simulate and render)
+//against NullRenderer or SoftwareRenderer, on one thread, every frame timed separately
+class GameLoopBenchmark
+{
+	GameLoopOptions			options;
+	//nanoseconds, reserved up front so recording them doesn't count as game heap traffic
+	std::vector<uint32_t>	frameCosts;
+
+	void playSyntheticGame(Renderer &renderer, int game);
+	//return game time covered by the record
+	unsigned int playRecord(Renderer &renderer);
+public:
+	static const int MAX_RECORDED_FRAMES = 1 << 20;
+
+	GameLoopBenchmark(const GameLoopOptions &o);
+
+	GameLoopReport run();
+
+	static void printReport(std::ostream &out, const GameLoopReport &report);
+	static void printJson(std::ostream &out, const GameLoopReport &report);
+};
+
+#endif
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "GameImpl.h"
+#include "GameSession.h"
+#include "Benchmark.h"
+#include "BoardCorpus.h"
+#include "GameLoopBenchmark.h"
+
+//long enough for every swap, kill and fall animation to finish
+static const unsigned int SETTLE_TIME = 10000;
+
+static void printUsage()
+{
+	std::cout << "usage: match3-bench [--boards N] [--seed N] [--min-time MS] [--filter KERNEL] [--json]" << std::endl;
+	std::cout << "       match3-bench --game-loop [--games N] [--seed N] [--frame-time MS] [--move-delay MS]"
+		" [--replay FILE] [--software] [--json]" << std::endl;
+}
+
+//board with the killing swap of corpus board done, its kills removed
+//and falling not yet simulated
+static void prepareFalling(Board &board, const BoardCorpus &corpus, int index)
+{
+	const Move &move = corpus.moves[index];
+	board.loadState(corpus.boards[index]);
+	board.swapBlocks(0, move.srcX, move.srcY, move.dstX, move.dstY);
+	board.simulateBlocks(SETTLE_TIME);
+	board.simulateKills(SETTLE_TIME);
+	board.simulateBlocks(2 * SETTLE_TIME);
+	board.removeDeadBlocks();
+}
+
+template<typename KillSearchT>
+static void measureKillSearch(Benchmark &benchmark, const char *kernel, const BoardCorpus &corpus,
+	const std::vector<BoardPtr> &boards)
+{
+	if(!benchmark.isSelected(kernel))
+	{
+		return;
+	}
+	std::vector<KillSearchT> searches;
+	for(const BoardPtr &board : boards)
+	{
+		searches.push_back(KillSearchT(*board));
+	}
+	benchmark.measure(kernel, corpus.name, (int)searches.size(), [&] (int i) {
+		searches[i].calculateKills();
+	});
+}
+
+static void measureCorpus(Benchmark &benchmark, Renderer &renderer, const BoardCorpus &corpus)
+{
+	const int size = (int)corpus.boards.size();
+	std::vector<BoardPtr> boards;
+	for(int i = 0; i < size; ++i)
+	{
+		boards.push_back(BoardPtr(new Board(renderer)));
+		boards.back()->loadState(corpus.boards[i]);
+	}
+
+	measureKillSearch<KillCalculator>(benchmark, "kill-calculator", corpus, boards);
+	measureKillSearch<KillTable>(benchmark, "kill-table", corpus, boards);
+
+	Board scratch(renderer);
+	benchmark.measure("simulate-falling", corpus.name, size, [&] (int) {
+		scratch.simulateFalling(2 * SETTLE_TIME);
+	}, [&] (int i) {
+		prepareFalling(scratch, corpus, i);
+	});
+
+	if(benchmark.isSelected("try-swap"))
+	{
+		//started game with a settled board as the template of every call
+		GameSession session(renderer, 0);
+		GameSessionCheckpoint checkpoint;
+		session.start();
+		session.step(0);
+		session.saveCheckpoint(checkpoint);
+		benchmark.measure("try-swap", corpus.name, size, [&] (int i) {
+			session.trySwap(corpus.moves[i]);
+		}, [&] (int i) {
+			checkpoint.board = corpus.boards[i];
+			session.loadCheckpoint(checkpoint);
+		});
+	}
+
+	int visited = 0;
+	benchmark.measure("apply-to-all-blocks", corpus.name, size, [&] (int i) {
+		boards[i]->applyToAllBlocks([&] (BlockID) {
+			visited++;
+		});
+	});
+	benchmark.measure("find-block", corpus.name, size, [&] (int i) {
+		const Board &board = *boards[i];
+		visited += board.findBlock([&] (BlockID b) -> bool {
+			return board.store.isSelected(b);
+		});
+	});
+}
+
+int main(int argc, char **argv)
+{
+	BenchmarkOptions options;
+	GameLoopOptions gameLoopOptions;
+	int boardCount = 256;
+	unsigned int seed = 1;
+	bool json = false;
+	bool gameLoop = false;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+		if(!strcmp(argv[i], "--boards") && hasValue)
+		{
+			boardCount = atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--seed") && hasValue)
+		{
+			seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		}
+		else if(!strcmp(argv[i], "--min-time") && hasValue)
+		{
+			options.minTime = (unsigned int)atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--filter") && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if(!strcmp(argv[i], "--json"))
+		{
+			json = true;
+		}
+		else if(!strcmp(argv[i], "--game-loop"))
+		{
+			gameLoop = true;
+		}
+		else if(!strcmp(argv[i], "--games") && hasValue)
+		{
+			gameLoopOptions.games = atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--frame-time") && hasValue)
+		{
+			gameLoopOptions.frameTime = (unsigned int)atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--move-delay") && hasValue)
+		{
+			gameLoopOptions.moveDelay = (unsigned int)atoi(argv[++i]);
+		}
+		else if(!strcmp(argv[i], "--replay") && hasValue)
+		{
+			gameLoopOptions.replayPath = argv[++i];
+		}
+		else if(!strcmp(argv[i], "--software"))
+		{
+			gameLoopOptions.software = true;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if(boardCount <= 0 || gameLoopOptions.games <= 0 || gameLoopOptions.frameTime == 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	if(gameLoop)
+	{
+		gameLoopOptions.seed = seed;
+		try
+		{
+			GameLoopBenchmark benchmark(gameLoopOptions);
+			GameLoopReport report = benchmark.run();
+			if(json)
+			{
+				GameLoopBenchmark::printJson(std::cout, report);
+			}
+			else
+			{
+				GameLoopBenchmark::printReport(std::cout, report);
+			}
+		}
+		catch(ReplayException *e)
+		{
+			std::cout << e->error << std::endl;
+			delete e;
+			return 1;
+		}
+		return 0;
+	}
+
+	NullRenderer renderer;
+	Benchmark benchmark(options);
+
+	const BoardCorpus corpora[] = {
+		createRandomCorpus(seed, boardCount),
+		createDenseMatchCorpus(seed, boardCount),
+		createDeepCascadeCorpus(seed, boardCount),
+	};
+	for(const BoardCorpus &corpus : corpora)
+	{
+		measureCorpus(benchmark, renderer, corpus);
+	}
+
+	Board board(renderer);
+	board.rng.seed(seed);
+	benchmark.measure("generate", "generated", boardCount, [&] (int) {
+		board.generate();
+	});
+
+	//generator alone, one board per call and in bulk mode; bulk calls fill
+	//POOL_CHUNK boards at once, so their cost is spread over the chunk
+	const int POOL_CHUNK = 64;
+	BoardRng generatorRng(seed);
+	BoardGenerator generator(generatorRng);
+	std::vector<Board::TypeGrid> pool(boardCount);
+	benchmark.measure("generate-grid", "generated", boardCount, [&] (int i) {
+		generator.generate(pool[i]);
+	});
+	benchmark.measure("generate-pool", "generated", boardCount, [&] (int i) {
+		if(0 == i % POOL_CHUNK)
+		{
+			generator.generate(&pool[i], std::min(POOL_CHUNK, boardCount - i));
+		}
+	});
+
+	if(json)
+	{
+		benchmark.printJson(std::cout);
+	}
+	else
+	{
+		benchmark.printTable(std::cout);
+	}
+	return 0;
+}